@@ -6,8 +6,78 @@
 #include <chrono>
 #include <stdexcept>
 #include <iomanip>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <exception>
+#include <optional>
+#include <sys/resource.h>
+
+/// @brief xoshiro256**, a small and fast generator of 64-bit numbers
+struct Xoshiro256 {
+    using result_type = std::uint64_t;
+
+    Xoshiro256(std::uint64_t seed) {
+        this->seed(seed);
+    }
+
+    /// @brief the state by splitmix64 from the seed, so close seeds give unrelated streams
+    void seed(std::uint64_t seed) {
+        for(std::uint64_t& word: s) {
+            seed += 0x9E3779B97F4A7C15ull;
+            std::uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    static constexpr result_type max() {
+        return UINT64_MAX;
+    }
+
+    result_type operator()() {
+        const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
 
-std::mt19937 rng(std::random_device{}()); // Set Mersenne twister
+    /// @brief a uniform number in [0, bound) by Lemire's multiply-shift: the 
+    /// high half of a 32-bit random times bound, redrawn in the rare cases 
+    /// whose low half would make some results likelier than others
+    std::uint32_t below(std::uint32_t bound) {
+        std::uint64_t m = ((*this)() >> 32) * bound;
+        if(std::uint32_t(m) < bound) {
+            const std::uint32_t threshold = -bound % bound;
+            while(std::uint32_t(m) < threshold) {
+                m = ((*this)() >> 32) * bound;
+            }
+        }
+        return m >> 32;
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t s[4];
+};
+
+thread_local Xoshiro256 rng(std::random_device{}()); // seeded anew on every thread, unless seeded explicitly
 
 
 template<typename T>
@@ -18,30 +88,99 @@ std::ostream& operator<<(std::ostream& os, const std::vector<T>& v) {
     return os << std::endl;
 }
 
+/// @brief a uniform number in [0, n]
 int gen_number(int n) {
-    return std::uniform_int_distribution<int>(0, n)(rng);
+    return rng.below(n + 1);
 }
 
 enum class Initialization {
     RAND,
     MIN_CONFL,
+    PERMUTATION, // every row taken once, most queens off each other's diagonals
+};
+
+enum class Search {
+    MAX_CONFL, // every step scans all queens and all rows
+    CONFLICTED, // every step takes a queen from the conflicted ones and a few candidate rows
+    SWAP, // every step swaps the rows of a conflicted queen and a random one
+};
+
+
+/// @brief a set of ids in [0, n) with constant time insertion, 
+/// removal and random picks
+struct IndexedSet {
+    static inline const int ABSENT{-1};
+
+    IndexedSet(int n=0)
+        :at(n, IndexedSet::ABSENT) {
+    }
+
+    void insert(int id) {
+        if(at[id] == IndexedSet::ABSENT) {
+            at[id] = ids.size();
+            ids.push_back(id);
+        }
+    }
+
+    void erase(int id) {
+        if(at[id] != IndexedSet::ABSENT) {
+            int last = ids.back();
+            ids[at[id]] = last;
+            at[last] = at[id];
+            ids.pop_back();
+            at[id] = IndexedSet::ABSENT;
+        }
+    }
+
+    bool empty() const {
+        return ids.empty();
+    }
+
+    int size() const {
+        return ids.size();
+    }
+
+    int operator[](int i) const {
+        return ids[i];
+    }
+
+    std::size_t bytes() const {
+        return (ids.capacity() + at.capacity()) * sizeof(int);
+    }
+
+    int random() const {
+        return ids[gen_number(ids.size() - 1)];
+    }
+
+private:
+    std::vector<int> ids;
+    std::vector<int> at; // index of every id in ids
 };
 
 
+template<typename Count=int>
 struct Board {
     /*
     Queen column positions are fixed & invariant to later movements.
     Board configurations are represented as arrays of size n.
+    The #queens on every row and diagonal are counted in Count, 
+    saturating: a counter at its max stays there, so it never undercounts 
+    and a line that overflowed is never taken for free.
     */
     static inline const int FREE{-1}; 
     static inline const int K{2};
+    static inline const int SAMPLES{4}; // candidate rows per step of the conflicted search
+    static inline const int TRIES{64}; // rows tried per queen by the permutation initialization
+    static inline const int TAIL{32}; // queens placed at random at its end
 
-    Board(int n=8, Initialization init=Initialization::RAND)
+    Board(int n=8, Initialization init=Initialization::RAND, Search search=Search::MAX_CONFL)
         :queens(n, Board::FREE),
          row_cnts(n),
          primary_cnts(2 * n - 1, 0),
          secondary_cnts(2 * n - 1, 0),
-         N(n) {
+         N(n),
+         init(init),
+         search(search) {
         
         if(n == 2 || n == 3) {
             throw std::runtime_error("-1"); // message modified to adhere to requirements
@@ -49,9 +188,15 @@ struct Board {
 
         if(init == Initialization::MIN_CONFL) {
             init_by_min_conf();
+        } else if(init == Initialization::PERMUTATION) {
+            init_by_permutation();
         } else {
             rand_init();
         }
+
+        if(search != Search::MAX_CONFL) {
+            track();
+        }
         
     }
 
@@ -83,13 +228,32 @@ struct Board {
         return col_max_conf[max_col_id];
     }
 
+    /// @brief a random queen out of the conflicted ones. 
+    /// Raises the solved flag if there are none
+    int queen_conflicted() {
+        if(conflicted.empty()) {
+            solved = true;
+            return Board::FREE;
+        }
+        return conflicted.random();
+    }
+
     void place_queen(int queen_id, int row) {
         
         if(queens[queen_id] == Board::FREE) {
-            ++row_cnts[row];
-            ++primary_cnts[primary(queen_id, row)];
-            ++secondary_cnts[secondary(queen_id, row)];
+            increment(row_cnts[row]);
+            increment(primary_cnts[primary(queen_id, row)]);
+            increment(secondary_cnts[secondary(queen_id, row)]);
             queens[queen_id] = row;
+
+            if(tracked) {
+                if(search == Search::CONFLICTED && row_cnts[row] == 1) {
+                    free_rows.erase(row);
+                }
+                join(queen_id, row_cnts[row], row_ids[row]);
+                join(queen_id, primary_cnts[primary(queen_id, row)], primary_ids[primary(queen_id, row)]);
+                join(queen_id, secondary_cnts[secondary(queen_id, row)], secondary_ids[secondary(queen_id, row)]);
+            }
         
         } else {
             remove_queen(queen_id);
@@ -101,10 +265,41 @@ struct Board {
         if(queens[queen_id] != Board::FREE) {
             int row = queens[queen_id];
 
-            --row_cnts[row];
-            --primary_cnts[primary(queen_id, row)];
-            --secondary_cnts[secondary(queen_id, row)];
+            decrement(row_cnts[row]);
+            decrement(primary_cnts[primary(queen_id, row)]);
+            decrement(secondary_cnts[secondary(queen_id, row)]);
             queens[queen_id] = Board::FREE;
+
+            if(tracked) {
+                if(search == Search::CONFLICTED && row_cnts[row] == 0) {
+                    free_rows.insert(row);
+                }
+                conflicted.erase(queen_id);
+                leave(queen_id, row_cnts[row], row_ids[row]);
+                leave(queen_id, primary_cnts[primary(queen_id, row)], primary_ids[primary(queen_id, row)]);
+                leave(queen_id, secondary_cnts[secondary(queen_id, row)], secondary_ids[secondary(queen_id, row)]);
+            }
+        }
+    }
+
+    /// @brief keeps the conflicted set after the queen joined a line, 
+    /// of cnt queens now, whose ids are xored in ids
+    void join(int queen_id, int cnt, int& ids) {
+        if(cnt == 2) {
+            conflicted.insert(ids); // the queen alone on it so far
+        }
+        if(cnt >= 2) {
+            conflicted.insert(queen_id);
+        }
+        ids ^= queen_id;
+    }
+
+    /// @brief keeps the conflicted set after the queen left a line, 
+    /// of cnt queens now
+    void leave(int queen_id, int cnt, int& ids) {
+        ids ^= queen_id;
+        if(cnt == 1 && conflicts(ids, queens[ids]) == 0) { // the queen left alone on it
+            conflicted.erase(ids);
         }
     }
 
@@ -119,6 +314,26 @@ struct Board {
 
 
 
+    static void increment(Count& cnt) {
+        if(cnt != std::numeric_limits<Count>::max()) {
+            ++cnt;
+        }
+    }
+
+    static void decrement(Count& cnt) {
+        if(cnt != std::numeric_limits<Count>::max()) {
+            --cnt;
+        }
+    }
+
+    /// @brief bytes taken by the board's arrays
+    std::size_t bytes() const {
+        return queens.capacity() * sizeof(int) +
+               (row_cnts.capacity() + primary_cnts.capacity() + secondary_cnts.capacity()) * sizeof(Count) +
+               (row_ids.capacity() + primary_ids.capacity() + secondary_ids.capacity()) * sizeof(int) +
+               conflicted.bytes() + free_rows.bytes();
+    }
+
     int primary(int col, int row) const {
         return col - row + N - 1;
     }
@@ -127,7 +342,8 @@ struct Board {
         return col + row;
     }
 
-    void solve() {
+    /// @brief min-conflicts search until solved or, if given, cancelled
+    void solve(const std::atomic<bool>* cancelled=nullptr) {
         int iter, col;
         // int been_there_done_that = 0;
 
@@ -137,9 +353,25 @@ struct Board {
         while(not(solved)) {
             iter = 0;
             while(iter++ <= limit) {
-                col = queen_max_conf(); // this raises the solved flag
-                if(not(solved)) {
-                    place_min_conf(col);
+                if(cancelled && cancelled->load(std::memory_order_relaxed)) {
+                    return;
+                }
+
+                if(search == Search::CONFLICTED) {
+                    col = queen_conflicted(); // this raises the solved flag
+                    if(not(solved)) {
+                        place_sampled_min_conf(col);
+                    }
+                } else if(search == Search::SWAP) {
+                    col = queen_conflicted();
+                    if(not(solved)) {
+                        swap_queens(col);
+                    }
+                } else {
+                    col = queen_max_conf(); // this raises the solved flag
+                    if(not(solved)) {
+                        place_min_conf(col);
+                    }
                 }
 
                 if(solved) {
@@ -148,7 +380,15 @@ struct Board {
                 }
             }
             if(not(solved)) {
-                rand_init(); // restart
+                tracked = false; // tracked again at once after the restart
+                if(init == Initialization::PERMUTATION) {
+                    init_by_permutation(); // restart, the swaps need a permutation
+                } else {
+                    rand_init(); // restart
+                }
+                if(search != Search::MAX_CONFL) {
+                    track();
+                }
             }
             // ++been_there_done_that;
         }
@@ -157,6 +397,10 @@ struct Board {
 
     }
 
+    bool is_solved() const {
+        return solved;
+    }
+
     void print_test_format() const {
         std::cout << "[";
         if(N) {
@@ -191,7 +435,70 @@ private:
         }
     }
 
+    /// @brief the xored ids, the conflicted queens and the free rows of 
+    /// the queens placed so far, kept by every move from now on
+    void track() {
+        row_ids.assign(N, 0);
+        primary_ids.assign(2 * N - 1, 0);
+        secondary_ids.assign(2 * N - 1, 0);
+        conflicted = IndexedSet(N);
+
+        for(int i = 0; i < N; ++i) {
+            row_ids[queens[i]] ^= i;
+            primary_ids[primary(i, queens[i])] ^= i;
+            secondary_ids[secondary(i, queens[i])] ^= i;
+        }
+        for(int i = 0; i < N; ++i) {
+            if(conflicts(i, queens[i]) > 0) {
+                conflicted.insert(i);
+            }
+        }
+
+        if(search == Search::CONFLICTED) {
+            free_rows = IndexedSet(N);
+            for(int row = 0; row < N; ++row) {
+                if(row_cnts[row] == 0) {
+                    free_rows.insert(row);
+                }
+            }
+        }
+
+        tracked = true;
+    }
+
+    /// @brief places the queens on distinct rows in expected linear time: 
+    /// every queen takes the first of a few random rows not taken yet 
+    /// whose diagonals are free, the last ones a random row not taken yet.
+    /// The rows are shuffled in place, the ones not taken yet follow queen i
+    void init_by_permutation() {
+        std::fill(row_cnts.begin(), row_cnts.end(), 0);
+        std::fill(primary_cnts.begin(), primary_cnts.end(), 0);
+        std::fill(secondary_cnts.begin(), secondary_cnts.end(), 0);
+        for(int row = 0; row < N; ++row) {
+            queens[row] = row;
+        }
+
+        for(int i = 0; i < N; ++i) {
+            int j = i + gen_number(N - 1 - i);
+            for(int tries = 1; i < N - Board::TAIL && tries < Board::TRIES && 
+                               (primary_cnts[primary(i, queens[j])] || secondary_cnts[secondary(i, queens[j])]); ++tries) {
+                j = i + gen_number(N - 1 - i);
+            }
+            std::swap(queens[i], queens[j]);
+            increment(row_cnts[queens[i]]);
+            increment(primary_cnts[primary(i, queens[i])]);
+            increment(secondary_cnts[secondary(i, queens[i])]);
+        }
+    }
+
+    /// @brief places every queen on a random row, from an empty board, 
+    /// so no counter stays saturated after a restart
     void rand_init() {
+        std::fill(row_cnts.begin(), row_cnts.end(), 0);
+        std::fill(primary_cnts.begin(), primary_cnts.end(), 0);
+        std::fill(secondary_cnts.begin(), secondary_cnts.end(), 0);
+        std::fill(queens.begin(), queens.end(), Board::FREE);
+
         int row;
         for(int i = 0; i < N; ++i) {
             row = gen_number(N - 1);
@@ -227,12 +534,71 @@ private:
         place_queen(queen_id, rows_min_conf[min_row_id]);
     }
 
+    /// @brief places the queen on column queen_id on the row with min 
+    /// #conflicts out of its own, a few free ones and a few random ones
+    void place_sampled_min_conf(int queen_id) {
+
+        int best_row = queens[queen_id];
+        int min_conf = conflicts(queen_id, best_row);
+        int ties = 1;
+
+        // all the free rows once there are few
+        int frees = free_rows.size() <= Board::SAMPLES ? free_rows.size() : Board::SAMPLES;
+        for(int i = 0; i < frees + Board::SAMPLES; ++i) {
+            int row = i >= frees ? gen_number(N - 1) : 
+                      free_rows.size() <= Board::SAMPLES ? free_rows[i] : free_rows.random();
+            int curr_conf = conflicts(queen_id, row);
+
+            if(curr_conf < min_conf) {
+                best_row = row;
+                min_conf = curr_conf;
+                ties = 1;
+
+            } else if(curr_conf == min_conf && gen_number(ties++) == 0) { // uniform over the ties
+                best_row = row;
+            }
+        }
+
+        place_queen(queen_id, best_row);
+    }
+
+    /// @brief swaps the rows of the queen on column queen_id and a random 
+    /// other one unless that adds conflicts, so every row stays taken once
+    void swap_queens(int queen_id) {
+        int other = gen_number(N - 1);
+        if(other == queen_id) {
+            return;
+        }
+
+        int before = conflicts(queen_id, queens[queen_id]) + conflicts(other, queens[other]);
+        swap_rows(queen_id, other);
+        int after = conflicts(queen_id, queens[queen_id]) + conflicts(other, queens[other]);
+
+        if(after > before) {
+            swap_rows(queen_id, other);
+        }
+    }
+
+    void swap_rows(int first, int second) {
+        int row = queens[first];
+        place_queen(first, queens[second]);
+        place_queen(second, row);
+    }
+
 
     std::vector<int> queens;
-    std::vector<int> row_cnts;
-    std::vector<int> primary_cnts;
-    std::vector<int> secondary_cnts;
+    std::vector<Count> row_cnts;
+    std::vector<Count> primary_cnts;
+    std::vector<Count> secondary_cnts;
     const int N;
+    const Initialization init;
+    const Search search;
+    std::vector<int> row_ids; // xor of the ids of the queens on every line, for the conflicted search
+    std::vector<int> primary_ids;
+    std::vector<int> secondary_ids;
+    IndexedSet conflicted;
+    IndexedSet free_rows; // for the conflicted search only
+    bool tracked = false; // whether moves keep the xored ids and the sets
     bool solved = false;
 
 };
@@ -242,19 +608,35 @@ private:
 struct ArgParser {
 
     ArgParser(int argc, char** args) {
-         if(argc > 2) {
-            throw std::runtime_error(usage);
-         } 
-
-         if(argc == 2) { // one arg
-            if(args[1] == std::string("time")) {
+         for(int i = 1; i < argc; ++i) {
+            if(args[i] == std::string("time")) {
                 time = true;
-            } else if(args[1] == std::string("test")) {
+            } else if(args[i] == std::string("test")) {
                 test = true;
+            } else if(args[i] == std::string("conflicted")) {
+                conflicted = true;
+            } else if(args[i] == std::string("permutation")) {
+                permutation = true;
+            } else if(args[i] == std::string("counters=8")) {
+                counter_bits = 8;
+            } else if(args[i] == std::string("counters=16")) {
+                counter_bits = 16;
+            } else if(args[i] == std::string("counters=32")) {
+                counter_bits = 32;
+            } else if(std::string(args[i]).rfind("threads=", 0) == 0) {
+                threads = std::stoi(std::string(args[i]).substr(8));
+                if(threads <= 0) {
+                    threads = std::max(1u, std::thread::hardware_concurrency());
+                }
+            } else if(std::string(args[i]).rfind("seed=", 0) == 0) {
+                seed = std::stoull(std::string(args[i]).substr(5));
             } else {
                 throw std::runtime_error(usage);
             }
-            assert(time ^ test);
+         }
+
+         if(time && test) {
+            throw std::runtime_error(usage);
          }
 
     }
@@ -262,50 +644,153 @@ struct ArgParser {
     
     bool time{false};
     bool test{false};
-
-    static inline const std::string usage{"Usage: <program name> <optional: time> <optional: test>"};
+    bool conflicted{false};
+    bool permutation{false};
+    int counter_bits{32};
+    int threads{1};
+    std::optional<std::uint64_t> seed; // the seed of the generator, of thread t's plus t
+
+    static inline const std::string usage{"Usage: <program name> <optional: time> <optional: test> "
+                                          "<optional: conflicted> <optional: permutation> "
+                                          "<optional: counters=<8|16|32>> <optional: threads=<n, 0 for all cores>> "
+                                          "<optional: seed=<s>>"};
 };
 
 
 
 
 
-int main(int argc, char** argv) try {
+/// @brief the peak resident memory of the process in MB
+double peak_memory() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0; // in KB on Linux
+}
 
-    ArgParser ap(argc, argv);
-    Initialization init = Initialization::MIN_CONFL; // Initial initialization
 
-    int n;
-    std::cin >> n;
-    Board b(n, init);
+/// @brief a portfolio of restarts: independent boards on threads threads, 
+/// each with a generator of its own, seeded anew or with seed plus the 
+/// thread's index, the first one solved cancels the rest
+/// @param initialization set to the time the solved board took to initialize
+/// @return the solved board
+template<typename Count>
+std::unique_ptr<Board<Count>> solve_portfolio(int n, Initialization init, Search search, int threads,
+                                              std::optional<std::uint64_t> seed,
+                                              std::chrono::duration<double>& initialization) {
+    std::vector<std::unique_ptr<Board<Count>>> boards(threads);
+    std::vector<std::chrono::duration<double>> initializations(threads);
+    std::atomic<bool> cancelled{false};
+    std::atomic<int> winner{-1};
+    std::exception_ptr error;
+
+    std::vector<std::thread> pool;
+    for(int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t]() {
+            try {
+                if(seed) {
+                    rng.seed(*seed + t);
+                }
+                const auto start = std::chrono::high_resolution_clock::now();
+                boards[t] = std::make_unique<Board<Count>>(n, init, search);
+                initializations[t] = std::chrono::high_resolution_clock::now() - start;
+                boards[t]->solve(&cancelled);
+
+                int none = -1;
+                if(boards[t]->is_solved() && winner.compare_exchange_strong(none, t)) {
+                    cancelled = true;
+                }
+            } catch(...) {
+                int none = -1;
+                if(winner.compare_exchange_strong(none, t)) { // the same for every board, e.g. no solution
+                    error = std::current_exception();
+                    cancelled = true;
+                }
+            }
+        });
+    }
+
+    for(std::thread& thread: pool) {
+        thread.join();
+    }
+
+    if(error) {
+        std::rethrow_exception(error);
+    }
+    initialization = initializations[winner];
+    return std::move(boards[winner]);
+}
+
+
+template<typename Count>
+void run(const ArgParser& ap, int n, Initialization init, Search search) {
+    const auto start = std::chrono::high_resolution_clock::now(); // the initialization is counted
+    std::chrono::duration<double> initialization{};
+    std::unique_ptr<Board<Count>> solved;
+
+    if(ap.threads > 1) {
+        solved = solve_portfolio<Count>(n, init, search, ap.threads, ap.seed, initialization);
+    } else {
+        if(ap.seed) {
+            rng.seed(*ap.seed);
+        }
+        solved = std::make_unique<Board<Count>>(n, init, search);
+        initialization = std::chrono::high_resolution_clock::now() - start;
+        solved->solve();
+    }
+    auto stop = std::chrono::high_resolution_clock::now();
+    const Board<Count>& b = *solved;
 
 
     if(ap.test) {
-        b.solve();
         b.print_test_format();
     
-        return 0;
+        return;
     } 
     
     if(ap.time) { 
-        auto start = std::chrono::high_resolution_clock::now();
-        b.solve();
-        auto stop = std::chrono::high_resolution_clock::now();
-        
         auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(stop - start);
 
 
         std::cout << "Execution time: " << 
                       std::fixed << std::setprecision(2) << 
-                      duration.count() << "s" << std::endl;
-
-    } else {
-        b.solve();
+                      duration.count() << "s, " <<
+                      "initialization: " << initialization.count() << "s" << std::endl;
+        std::cout << "Peak memory: " << peak_memory() << "MB, " <<
+                     "board: " << b.bytes() / (1024.0 * 1024.0) << "MB" << std::endl;
     }
 
     if(n < 101) {
         std::cout << b;
     }
+}
+
+
+int main(int argc, char** argv) try {
+
+    ArgParser ap(argc, argv);
+    Initialization init = Initialization::MIN_CONFL; // Initial initialization
+    Search search = Search::MAX_CONFL;
+
+    if(ap.conflicted) {
+        init = Initialization::RAND; // placing every queen by min #conflicts scans all rows
+        search = Search::CONFLICTED;
+    }
+
+    if(ap.permutation) {
+        init = Initialization::PERMUTATION;
+        search = Search::SWAP;
+    }
+
+    int n;
+    std::cin >> n;
+
+    if(ap.counter_bits == 8) {
+        run<std::uint8_t>(ap, n, init, search);
+    } else if(ap.counter_bits == 16) {
+        run<std::uint16_t>(ap, n, init, search);
+    } else {
+        run<int>(ap, n, init, search);
+    }
 
     return 0;
 
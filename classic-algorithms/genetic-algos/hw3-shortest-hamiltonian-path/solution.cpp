@@ -9,8 +9,71 @@
 #include <iomanip>
 #include <functional>
 #include <cstddef>
+#include <cstdint>
+#include <string>
 
-std::mt19937 rng(std::random_device{}()); // Set Mersenne Twister
+/// @brief xoshiro256**, a small and fast generator of 64-bit numbers
+struct Xoshiro256 {
+    using result_type = std::uint64_t;
+
+    Xoshiro256(std::uint64_t seed) {
+        this->seed(seed);
+    }
+
+    /// @brief the state by splitmix64 from the seed, so close seeds give unrelated streams
+    void seed(std::uint64_t seed) {
+        for(std::uint64_t& word: s) {
+            seed += 0x9E3779B97F4A7C15ull;
+            std::uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    static constexpr result_type max() {
+        return UINT64_MAX;
+    }
+
+    result_type operator()() {
+        const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    /// @brief a uniform number in [0, bound) by Lemire's multiply-shift: the 
+    /// high half of a 32-bit random times bound, redrawn in the rare cases 
+    /// whose low half would make some results likelier than others
+    std::uint32_t below(std::uint32_t bound) {
+        std::uint64_t m = ((*this)() >> 32) * bound;
+        if(std::uint32_t(m) < bound) {
+            const std::uint32_t threshold = -bound % bound;
+            while(std::uint32_t(m) < threshold) {
+                m = ((*this)() >> 32) * bound;
+            }
+        }
+        return m >> 32;
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t s[4];
+};
+
+thread_local Xoshiro256 rng(std::random_device{}()); // seeded anew on every thread, unless seeded explicitly
 
 /// Utility functions
 
@@ -31,13 +94,15 @@ std::ostream& operator<<(std::ostream& os,
     return os << std::endl;
 }
 
+/// @brief a uniform number in [0, n]
 int gen_number(int n) {
-    return std::uniform_int_distribution<int>(0, n)(rng);
+    return rng.below(n + 1);
 }
 
 
+/// @brief a uniform number in [0, 1), from the high 53 bits
 double gen_prob() {
-    return std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    return (rng() >> 11) * 0x1.0p-53;
 }
 
 /// End of utility functions
@@ -257,7 +322,7 @@ private:
         for(int i = 0; i < size; ++i) {
             path[i] = i;
         }
-        std::random_shuffle(path.begin(), path.end());
+        std::shuffle(path.begin(), path.end(), rng);
     }
 
     void calc_unfitness(const Coordinates& c) {
@@ -472,10 +537,19 @@ private:
 int main(int argc, char** argv) {
     const int max_iter = 1000;
 
-    if(argc > 2 || (argc == 2 && argv[1] != std::string("test"))) {
-        std::cout << "Usage: <program name> <optional: test>" << std::endl;
-        return -1;
-    } else if(argc == 2) {
+    bool test{false};
+    for(int i = 1; i < argc; ++i) {
+        if(argv[i] == std::string("test")) {
+            test = true;
+        } else if(std::string(argv[i]).rfind("seed=", 0) == 0) {
+            rng.seed(std::stoull(std::string(argv[i]).substr(5))); // for reproducible runs
+        } else {
+            std::cout << "Usage: <program name> <optional: test> <optional: seed=<s>>" << std::endl;
+            return -1;
+        }
+    }
+
+    if(test) {
         std::vector<Coordinate> cs{ {500.000190032, 499.999714054}, // translated so as to be non-negative
                                     {883.4580000000001, 499.999391244},
                                     {472.9794, 217.24200000000002}, 
@@ -8,13 +8,38 @@
 #include <utility>
 #include <climits>
 #include <chrono>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <unordered_set>
+#include <type_traits>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+#include <array>
+#include <string>
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BATCH_SIMD // SSSE3 and AVX2 kernels of BatchEvaluator, picked at runtime
+#include <immintrin.h>
+#endif
 
 
 
 using board = std::vector<std::vector<int>>; // matrix representation
 
 using dict = std::unordered_map<int, std::pair<int, int>>; // to save goal state
-using string_dict = std::unordered_map<std::string, std::string>;
 
 
 struct Move {
@@ -29,9 +54,6 @@ struct Move {
 
 
 
-using string_move_dict = std::unordered_map<std::string, Move>;
-
-
 std::istream& operator>>(std::istream& is,
                          board& b) { 
     for(int i = 0; i < b.size(); ++i) {
@@ -54,19 +76,11 @@ std::ostream& operator<<(std::ostream& os,
     return os;
 }
 
-std::ostream& operator<<(std::ostream& os, 
-                         const std::vector<std::string>& v) {
-    for(const std::string& elem: v) {
-        os << elem << '\n';
-    }
-    return os << std::endl;
-}
-
 
 /// @brief A Board represents a node
 struct Board { 
 
-    Board(const int dim, dict& target):
+    Board(const int dim, const dict& target):
         tiles(std::vector<std::vector<int>>(dim)), 
         target(target) { 
         
@@ -83,8 +97,8 @@ struct Board {
             for(int j = 0; j < size(); ++j) {
                 number = tiles[i][j];
                 if(number) {
-                    dist += std::abs(i - target[number].first) +
-                            std::abs(j - target[number].second); 
+                    dist += std::abs(i - target.at(number).first) +
+                            std::abs(j - target.at(number).second); 
                 }
             }
         }
@@ -103,8 +117,8 @@ struct Board {
             for(int j = 0; j < size(); ++j) {
                 number = tiles[i][j];
                 if(number) {
-                    dist += i != target[number].first ||
-                            j != target[number].second; 
+                    dist += i != target.at(number).first ||
+                            j != target.at(number).second; 
                 }
             }
         }
@@ -115,9 +129,10 @@ struct Board {
         const int inv = num_inversions();
         const int dim = size();
         int blank_row = zero_id / dim;
+        int goal_blank_row = target.at(0).first; // the goal has no inversions
 
         return (dim % 2 != 0 && inv % 2 == 0) ||
-               (dim % 2 == 0 && (inv + blank_row) % 2 != 0);  
+               (dim % 2 == 0 && (inv + blank_row + goal_blank_row) % 2 == 0);  
     }
 
     int size() const {
@@ -143,13 +158,18 @@ struct Board {
         return false;
     }
 
+    /// @param move index in move_order, move ^ 1 takes it back
+    bool apply_move(int move) {
+        return apply_move(steps[move]);
+    }
+
     bool within_limits(int id) const {
         return (id >= 0 && id < size()); 
     }
  
     board tiles;
     int zero_id{0};
-    dict& target;
+    const dict& target;
 // private:
     int num_inversions() const { // bubble sort, the stupid way, ikr
                                  // the merge sort way is faster, yet 
@@ -167,10 +187,10 @@ struct Board {
                     zx = k / dim;
                     zy = k % dim;
 
-                    if(tiles[zx][zy] && target[tiles[zx][zy]].first * dim +
-                                        target[tiles[zx][zy]].second < 
-                                        target[tiles[x][y]].first * dim +
-                                        target[tiles[x][y]].second) {
+                    if(tiles[zx][zy] && target.at(tiles[zx][zy]).first * dim +
+                                        target.at(tiles[zx][zy]).second < 
+                                        target.at(tiles[x][y]).first * dim +
+                                        target.at(tiles[x][y]).second) {
                         ++inversions;
                     }
                 }   
@@ -180,6 +200,10 @@ struct Board {
         return inversions;
     } 
 
+    int at(int id) const {
+        return tiles[id / size()][id % size()];
+    }
+
     std::pair<int, int> blank_coordinates() {
         int dim = size();
         for(int i = 0; i < dim; ++i) {
@@ -194,18 +218,191 @@ struct Board {
     }
 
 
-    /// @brief  with respect to the blank position
-    static inline string_move_dict moves = { {"left", Move{0, 1}}, 
-                                             {"right", Move{0, -1}}, 
-                                             {"down", Move{-1, 0}},
-                                             {"up", Move{1, 0}}, };
-    
-    static inline string_dict opposite_name { {"left", "right"},
-                                              {"right", "left"}, 
-                                              {"up", "down"}, 
-                                              {"down", "up"}, };
+    /// @brief the order the search tries moves in, the expected 
+    /// test outputs depend on it; moves are indexed by it
+    static inline const std::array<std::string, 4> move_order{"up", "down", "right", "left"};
+
+    /// @brief the Move of each index of move_order
+    static constexpr std::array<Move, 4> steps{{{1, 0}, {-1, 0}, {0, -1}, {0, 1}}};
+
+    static constexpr bool PACKED = false; // see PackedBoard
+
+};
+
+
+/// @brief A stack of at most N elements held inline, 
+/// so pushing and popping never allocates
+template<typename T, int N>
+struct FixedStack {
+
+    static constexpr int CAPACITY = N;
+
+    void push_back(T item) {
+        assert(count < N);
+        items[count++] = item;
+    }
+
+    void pop_back() {
+        --count;
+    }
+
+    T back() const {
+        return items[count - 1];
+    }
+
+    T operator[](int i) const {
+        return items[i];
+    }
+
+    int size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+private:
+    std::array<T, N> items;
+    int count{0};
+};
+
+
+static constexpr int MAX_SOLUTION_LENGTH = 1024; // moves, the depth of the search stack
+
+/// @brief the moves of a path as indices of Board::move_order
+using MoveStack = FixedStack<std::uint8_t, MAX_SOLUTION_LENGTH>;
+
+/// @brief names the moves only here, on output
+std::ostream& operator<<(std::ostream& os, const MoveStack& path) {
+    for(int i = 0; i < path.size(); ++i) {
+        os << Board::move_order[path[i]] << '\n';
+    }
+    return os << std::endl;
+}
+
+
+/// @brief the cell the blank moves to from each cell of a DIM x DIM board, 
+/// by move index, -1 where it would leave the board
+template<int DIM>
+struct Neighbours {
+
+    static constexpr int CELLS = DIM * DIM;
+
+    static constexpr std::array<std::array<int, 4>, CELLS> make() {
+        std::array<std::array<int, 4>, CELLS> table{};
+
+        for(int id = 0; id < CELLS; ++id) {
+            for(int m = 0; m < 4; ++m) {
+                const int x = id / DIM + Board::steps[m].x;
+                const int y = id % DIM + Board::steps[m].y;
+                table[id][m] = x < 0 || x >= DIM || y < 0 || y >= DIM ? -1 : x * DIM + y;
+            }
+        }
+        return table;
+    }
+
+    static constexpr std::array<std::array<int, 4>, CELLS> table = make();
+};
+
+
+static constexpr int MAX_PACKED_DIM = 4; // 16 nibbles fit in 64 bits
+
+
+/// @brief A Board of a size fixed at compile time packed into a single 
+/// 64-bit word, cell i holds its tile in the nibble at bits [4i, 4i + 4)
+template<int DIM>
+struct PackedBoard {
+
+    static_assert(DIM <= MAX_PACKED_DIM, "the board does not fit in 64 bits");
+
+    static constexpr bool PACKED = true;
+    static constexpr int CELLS = DIM * DIM;
+
+    explicit PackedBoard(const Board& b): 
+        zero_id(b.zero_id) {
+        
+        assert(b.size() == DIM);
+
+        for(int i = 0; i < CELLS; ++i) {
+            tiles |= std::uint64_t(b.at(i)) << (4 * i);
+        }
+    }
+
+    static constexpr int size() {
+        return DIM;
+    }
+
+    int at(int id) const {
+        return (tiles >> (4 * id)) & 0xF;
+    }
+
+    /// @param move index in Board::move_order
+    bool apply_move(int move) {
+        const int id = Neighbours<DIM>::table[zero_id][move];
+        if(id < 0) {
+            return false;
+        }
+
+        const std::uint64_t tile = (tiles >> (4 * id)) & 0xF;
+        
+        // the blank nibble is 0, so xor-ing the tile into both 
+        // cells clears its old nibble and sets the new one
+        tiles ^= (tile << (4 * id)) | (tile << (4 * zero_id));
+        zero_id = id; // update zero pos
+        return true;
+    }
+
+    std::uint64_t tiles{0};
+    int zero_id;
+};
+
+
+/// @brief A Board of a size fixed at compile time, a byte per cell, 
+/// for the boards too big to pack
+template<int DIM>
+struct ArrayBoard {
+
+    static constexpr bool PACKED = false;
+    static constexpr int CELLS = DIM * DIM;
+
+    explicit ArrayBoard(const Board& b): 
+        zero_id(b.zero_id) {
 
+        assert(b.size() == DIM);
 
+        for(int i = 0; i < CELLS; ++i) {
+            tiles[i] = b.at(i);
+        }
+    }
+
+    static constexpr int size() {
+        return DIM;
+    }
+
+    int at(int id) const {
+        return tiles[id];
+    }
+
+    /// @param move index in Board::move_order
+    bool apply_move(int move) {
+        const int id = Neighbours<DIM>::table[zero_id][move];
+        if(id < 0) {
+            return false;
+        }
+
+        tiles[zero_id] = tiles[id];
+        tiles[id] = 0;
+        zero_id = id; // update zero pos
+        return true;
+    }
+
+    std::array<std::uint8_t, CELLS> tiles{};
+    int zero_id;
 };
 
 
@@ -245,8 +442,51 @@ struct Target {
         return posistions.size();
     }
 
+    /// @brief the goal cell of a tile, the goal blank cell for 0
+    int goal(int tile) const {
+        return goals[tile];
+    }
+
+    /// @brief Manhattan distance of a tile on cell id from its goal cell
+    int distance(int tile, int id) const {
+        return distances[tile * cells + id];
+    }
+
+    /// @brief the target with the tiles where they are on the board, 
+    /// e.g. the start of a puzzle, for a search back from the goal
+    static Target of(const Board& b) {
+        Target t;
+        const int dim = b.size();
+        for(int id = 0; id < dim * dim; ++id) {
+            t.posistions[b.at(id)] = {id / dim, id % dim};
+        }
+        t.init_tables(dim);
+        return t;
+    }
+
+    /// @brief full Manhattan distance of any of the boards, 
+    /// the search updates it incrementally from here on
+    template<typename B>
+    int manhattan(const B& b) const {
+        int dist{0};
+        int number{42}; // initial value does not matter
+
+        for(int i = 0; i < b.size() * b.size(); ++i) {
+            number = b.at(i);
+            if(number) {
+                dist += distance(number, i);
+            }
+        }
+        return dist;
+    }
+
 private:
 
+    int cells{0};
+    std::vector<int> goals; // tile -> goal cell
+    std::vector<int> distances; // [tile][cell] flattened, the blank row is all zeros
+
+
     /// @brief create the target as a dictionary, 
     /// for linear heuristic metric calculation 
     void init_target(int dim, int zero_id) {
@@ -275,6 +515,30 @@ private:
             posistions[i] = {x, y};
         }
 
+        init_tables(dim);
+    }
+
+    /// @brief the goal cells and distances of the positions
+    void init_tables(int dim) {
+        const int len = dim * dim;
+
+        cells = len;
+        goals.assign(len, 0);
+        distances.assign(len * len, 0);
+
+        for(int tile = 0; tile < len; ++tile) {
+            goals[tile] = posistions[tile].first * dim + posistions[tile].second;
+        }
+
+        for(int tile = 1; tile < len; ++tile) {
+            const std::pair<int, int>& goal = posistions[tile];
+            
+            for(int i = 0; i < len; ++i) {
+                distances[tile * len + i] = std::abs(i / dim - goal.first) +
+                                            std::abs(i % dim - goal.second);
+            }
+        }
+
     }
 
     static int get_dim(const int n) {
@@ -289,165 +553,3611 @@ private:
 };
 
 
-struct Solution {
-
-    static inline const int FOUND = -1;
-
-    Target& target;
-    Board b;
+/// @brief read-only mapping of a whole file, 
+/// processes mapping the same file share its page cache copy
+struct MappedFile {
 
-    std::vector<std::string> path;
-    int sol_cost = INT_MAX;
+    explicit MappedFile(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) {
+            throw std::runtime_error("Cannot open " + path);
+        }
 
-    /// @brief  performs depth-limited search
-    /// @param g the cost function, level-wise
-    /// @param threshold determines the termination condition
-    /// @return  FOUND if the goal state is reached
-    int search(int g, int threshold) {
-        int h = b.manhattan();
-        int f = g + h;
-        if(f > threshold) {
-            return f;
+        struct stat st;
+        if(::fstat(fd, &st) == 0 && st.st_size > 0) {
+            size = st.st_size;
+            void* addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            data = addr != MAP_FAILED ? static_cast<const std::uint8_t*>(addr) : nullptr;
         }
+        ::close(fd);
 
-        if(h == 0) { // Goal state reached
-            sol_cost = g;
-            return FOUND;
+        if(not(data)) {
+            throw std::runtime_error("Cannot map " + path);
         }
+    }
 
+    ~MappedFile() {
+        ::munmap(const_cast<std::uint8_t*>(data), size);
+    }
 
-        int min = INT_MAX;
-        int temp{42};
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
 
+    static bool exists(const std::string& path) {
+        struct stat st;
+        return ::stat(path.c_str(), &st) == 0;
+    }
 
-        for(const auto& name_move: Board::moves) {
-            if((not(path.empty()) &&
-                path.back() != Board::opposite_name[name_move.first]) || path.empty()) {
-            
-                if(b.apply_move(name_move.second)) {
+    const std::uint8_t* data{nullptr};
+    std::size_t size{0};
+};
 
-                    path.push_back(name_move.first);
-                    temp = search(g + 1, threshold);
 
-                    if(temp == FOUND) {
-                        return FOUND;
-                    } 
-                    if(temp < min) {
-                        min = temp;
-                    }
+/// @brief Reads the 64-bit integers [begin, end) of a file in order, a block at a time
+struct IntFileReader {
 
-                    b.apply_move(name_move.second.reverse());    
-                    path.pop_back();
-                }
-                
-            }
+    IntFileReader(const std::string& path, std::uint64_t begin = 0, std::uint64_t end = UINT64_MAX):
+        file(std::fopen(path.c_str(), "rb")),
+        left(end - begin) {
+
+        if(not(file) || std::fseek(file, begin * sizeof(std::uint64_t), SEEK_SET) != 0) {
+            throw std::runtime_error("Cannot read " + path);
         }
+        refill();
+    }
 
-        return min;
+    ~IntFileReader() {
+        if(file) {
+            std::fclose(file);
+        }
     }
 
-    void idastar() {
-        int threshold = b.manhattan(); // the heuristic value of root
-        int temp{42};
+    IntFileReader(IntFileReader&& r) noexcept:
+        file(std::exchange(r.file, nullptr)),
+        left(r.left),
+        buffer(std::move(r.buffer)),
+        pos(r.pos) {
+    }
 
-        while(42) {
-            temp = search(0, threshold);
-            if(temp == FOUND) {
-                break;
-            } else {
-                threshold = temp;
-            }
+    bool empty() const {
+        return pos == buffer.size();
+    }
+
+    std::uint64_t front() const {
+        return buffer[pos];
+    }
+
+    void pop() {
+        if(++pos == buffer.size()) {
+            refill();
         }
     }
 
+private:
 
+    static inline const std::size_t BLOCK = 1 << 15; // integers
 
-    Solution(Target& t): target(t), 
-                         b(std::sqrt(t.size()),
-                           t.posistions) {
-    } 
+    void refill() {
+        buffer.resize(std::min<std::uint64_t>(BLOCK, left));
+        buffer.resize(std::fread(buffer.data(), sizeof(std::uint64_t), buffer.size(), file));
+        left -= buffer.size();
+        pos = 0;
+    }
 
-    friend std::istream& operator>>(std::istream& is,
-                                    Solution& s) {
-        is >> s.b.tiles;
-        s.b.blank_coordinates();
-        
-        if(not(s.b.solvable())) {
-            throw(std::runtime_error("-1")); // text modified to adhere to output requirements
+    std::FILE* file;
+    std::uint64_t left; // integers not read yet
+    std::vector<std::uint64_t> buffer;
+    std::size_t pos{0};
+};
+
+
+/// @brief Appends 64-bit integers to a new file, a block at a time
+struct IntFileWriter {
+
+    explicit IntFileWriter(const std::string& path):
+        path(path),
+        file(std::fopen(path.c_str(), "wb")) {
+
+        if(not(file)) {
+            throw std::runtime_error("Cannot write " + path);
         }
+        buffer.reserve(BLOCK);
+    }
 
-        return is;
+    ~IntFileWriter() {
+        if(file) {
+            std::fclose(file);
+        }
     }
 
-    friend std::ostream& operator<<(std::ostream& os, 
-                                    Solution& s) {
+    void push(std::uint64_t value) {
+        buffer.push_back(value);
+        if(buffer.size() == BLOCK) {
+            flush();
+        }
+        ++count;
+    }
 
-        os << s.sol_cost << '\n';
-    
-        return os << s.path;
+    /// @return the number of integers written
+    std::uint64_t close() {
+        flush();
+        const bool failed = std::fclose(std::exchange(file, nullptr)) != 0;
+        if(failed) {
+            throw std::runtime_error("Cannot write " + path);
+        }
+        return count;
+    }
+
+private:
+
+    static inline const std::size_t BLOCK = 1 << 15; // integers
+
+    void flush() {
+        if(std::fwrite(buffer.data(), sizeof(std::uint64_t), buffer.size(), file) != buffer.size()) {
+            throw std::runtime_error("Cannot write " + path);
+        }
+        buffer.clear();
     }
 
+    std::string path;
+    std::FILE* file;
+    std::vector<std::uint64_t> buffer;
+    std::uint64_t count{0};
+};
+
 
+/// @brief How PatternDatabase builds a table on disk rather than in memory
+struct ExternalPdbBuild {
+    std::string dir; // of the layer and run files, removed when done
+    std::size_t memory; // bytes of states buffered by all threads before they are sorted to runs
+    int threads;
 };
 
 
+/// @brief One pattern of an additive disjoint pattern database.
+/// Stores, for every placement of the pattern tiles, the least number 
+/// of moves *of pattern tiles* needed to bring them to their goal cells.
+/// Placements are indexed by their rank as a partial permutation.
+/// 
+/// That number has the parity of the pattern's Manhattan distance, so only 
+/// half the excess over it is kept, in a 4-bit entry clamped at 15.
+/// Clamping lowers the estimate, the heuristic stays admissible.
+struct PatternDatabase {
 
-struct ArgParser {
+    static inline const std::uint8_t UNSEEN = 0xFF;
+    static inline const int MAX_ENTRY = 0xF;
 
-    ArgParser(char** args) {
-        int iter{0};
+    /// @brief builds the pattern database
+    PatternDatabase(const Target& t, const std::vector<int>& pattern_tiles):
+        tiles(pattern_tiles),
+        dim(std::sqrt(t.size())),
+        cells(t.size()) {
 
-        while(*(++args)) {
-            ++iter;
+        init_weights();
+        init_adjacent();
+        build(t);
+    }
 
-            if(iter > 1) {
-                throw std::runtime_error("Wrong argument count!");
-            } else if(*args != std::string("t")) {
+    /// @brief builds the pattern database with its breadth-first search 
+    /// layers on disk, in memory bounded by the options and a bit and a 
+    /// nibble per placement
+    PatternDatabase(const Target& t, const std::vector<int>& pattern_tiles,
+                    const ExternalPdbBuild& options):
+        tiles(pattern_tiles),
+        dim(std::sqrt(t.size())),
+        cells(t.size()) {
 
-                std::cout << *args << std::endl;
-                throw std::runtime_error(usage);
+        init_weights();
+        init_adjacent();
+        build_external(t, options);
+    }
 
-            } else {
-                time = true;
+    /// @brief a view of packed entries stored elsewhere, e.g. a mapped file
+    PatternDatabase(const Target& t, const std::vector<int>& pattern_tiles,
+                    const std::uint8_t* entries):
+        tiles(pattern_tiles),
+        dim(std::sqrt(t.size())),
+        cells(t.size()),
+        mapped(entries) {
+
+        init_weights();
+    }
+
+    /// @param placed placed[i] is the cell of tiles[i]
+    std::uint64_t rank(const int* placed) const {
+        std::uint64_t r{0};
+        std::uint64_t used{0};
+
+        for(int i = 0; i < int(tiles.size()); ++i) {
+            const std::uint64_t below = (std::uint64_t(1) << placed[i]) - 1;
+            r += (placed[i] - __builtin_popcountll(used & below)) * weights[i];
+            used |= std::uint64_t(1) << placed[i];
+        }
+        return r;
+    }
+
+    void unrank(std::uint64_t r, int* placed) const {
+        std::uint64_t used{0};
+
+        for(int i = 0; i < int(tiles.size()); ++i) {
+            int digit = r / weights[i];
+            r %= weights[i];
+
+            int id = 0;
+            while(used >> id & 1 || digit--) { // the digit-th free cell
+                ++id;
             }
-        } 
+            placed[i] = id;
+            used |= std::uint64_t(1) << id;
+        }
     }
 
-    
-    bool time{false};
+    /// @param pos pos[tile] is the cell of the tile
+    /// @return half the moves needed above the pattern's Manhattan distance
+    template<typename P>
+    int value(const P& pos) const {
+        int placed[64];
+        for(int i = 0; i < int(tiles.size()); ++i) {
+            placed[i] = pos[tiles[i]];
+        }
+        return entry(rank(placed));
+    }
 
-    static inline const std::string usage{"Usage: <program name> <optional: t>"};
-};
+    int entry(std::uint64_t r) const {
+        return nibbles()[r >> 1] >> ((r & 1) * 4) & 0xF;
+    }
 
+    std::uint64_t entries() const {
+        return weights[0] * cells;
+    }
 
+    /// @brief size of the packed entries, two per byte
+    std::uint64_t bytes() const {
+        return (entries() + 1) / 2;
+    }
 
-int main(int argc, char** argv) try {
+    const std::uint8_t* nibbles() const {
+        return mapped ? mapped : packed.data();
+    }
 
-    ArgParser ap(argv);
+    std::vector<int> tiles;
+    std::vector<std::uint64_t> weights;
+    int dim;
+    int cells;
 
-    Target t;
-    std::cin >> t;
+private:
 
-    Solution s(t);
-    std::cin >> s;
+    std::vector<std::uint8_t> packed; // owned entries, if built here
+    const std::uint8_t* mapped{nullptr};
+    std::vector<std::uint64_t> adjacent; // cell -> neighbour cells
 
-    if(ap.time) {
-        auto start = std::chrono::high_resolution_clock::now();
-        s.idastar();
-        auto stop = std::chrono::high_resolution_clock::now();
-    
-        auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(stop - start);
-        std::cout << "\nExecution time: " << duration.count() << "s\n\n" << std::endl;
+    static inline std::atomic<int> builds{0}; // tell the files of concurrent builds apart
 
-    } else {
-        s.idastar();
+    void init_weights() {
+        const int k = tiles.size();
+        weights.assign(k, 1);
+
+        // weights[i] = (cells - 1 - i)! / (cells - k)!
+        for(int i = k - 2; i >= 0; --i) {
+            weights[i] = weights[i + 1] * (cells - 1 - i);
+        }
     }
 
-    std::cout << s;
+    void init_adjacent() {
+        adjacent.assign(cells, 0);
 
-    return 0;
+        for(int id = 0; id < cells; ++id) {
+            const int x = id / dim;
+            const int y = id % dim;
+            if(x > 0)       adjacent[id] |= std::uint64_t(1) << (id - dim);
+            if(x < dim - 1) adjacent[id] |= std::uint64_t(1) << (id + dim);
+            if(y > 0)       adjacent[id] |= std::uint64_t(1) << (id - 1);
+            if(y < dim - 1) adjacent[id] |= std::uint64_t(1) << (id + 1);
+        }
+    }
 
-} catch(const std::exception& e) { 
+    /// @brief free cells the blank reaches from cell id without moving a pattern tile
+    std::uint64_t flood(std::uint64_t occupied, int id) const {
+        std::uint64_t region = std::uint64_t(1) << id;
+        std::uint64_t frontier = region;
 
-    std::cout << e.what() << std::endl; 
-}
\ No newline at end of file
+        while(frontier) {
+            const std::uint64_t grown = adjacent[__builtin_ctzll(frontier)] & 
+                                        ~occupied & ~region;
+            frontier &= frontier - 1;
+            region |= grown;
+            frontier |= grown;
+        }
+        return region;
+    }
+
+    /// @brief the entry of placement r, first reached at the given depth
+    int half_excess(const Target& t, std::uint64_t r, int depth) const {
+        int placed[64];
+        unrank(r, placed);
+
+        int md{0};
+        for(int i = 0; i < int(tiles.size()); ++i) {
+            md += t.distance(tiles[i], placed[i]);
+        }
+        return std::min((depth - md) / 2, MAX_ENTRY);
+    }
+
+    /// @brief breadth-first search backwards from the goal placement.
+    /// Only moves of pattern tiles cost anything, so a state is a placement 
+    /// together with the region of free cells the blank can wander in at 
+    /// no cost. A bit per (placement, blank cell) marks the regions seen;
+    /// the first depth a placement is reached at is its value.
+    void build(const Target& t) {
+        const int k = tiles.size();
+        std::vector<bool> seen(entries() * cells, false);
+        std::vector<int> placed(k);
+        std::vector<int> owner(cells, -1); // cell -> index in tiles, -1 if none
+
+        auto mark = [&seen, this](std::uint64_t r, std::uint64_t region) {
+            for(; region; region &= region - 1) {
+                seen[r * cells + __builtin_ctzll(region)] = true;
+            }
+        };
+
+        // layer entries hold the blank and the placement in 6-bit fields
+        auto pack = [k](const std::vector<int>& placed, int blank) {
+            std::uint64_t state = blank;
+            for(int i = 0; i < k; ++i) {
+                state |= std::uint64_t(placed[i]) << (6 * (i + 1));
+            }
+            return state;
+        };
+
+        std::uint64_t occupied{0};
+        for(int i = 0; i < k; ++i) {
+            placed[i] = t.goal(tiles[i]);
+            occupied |= std::uint64_t(1) << placed[i];
+        }
+
+        const std::uint64_t start = rank(placed.data());
+        std::vector<std::uint8_t> table(entries(), UNSEEN);
+        table[start] = 0;
+        mark(start, flood(occupied, t.goal(0)));
+
+        std::vector<std::uint64_t> layer{pack(placed, t.goal(0))};
+        std::vector<std::uint64_t> next;
+        std::uint8_t depth{0};
+
+        while(not(layer.empty())) {
+            for(const std::uint64_t state: layer) {
+                occupied = 0;
+                for(int i = 0; i < k; ++i) {
+                    placed[i] = state >> (6 * (i + 1)) & 0x3F;
+                    owner[placed[i]] = i;
+                    occupied |= std::uint64_t(1) << placed[i];
+                }
+
+                for(std::uint64_t region = flood(occupied, state & 0x3F); 
+                    region; region &= region - 1) {
+                    
+                    const int blank = __builtin_ctzll(region);
+
+                    for(std::uint64_t near = adjacent[blank] & occupied; 
+                        near; near &= near - 1) {
+                        
+                        // the pattern tile on cell id slides onto the blank
+                        const int id = __builtin_ctzll(near);
+                        const int j = owner[id];
+
+                        placed[j] = blank;
+                        const std::uint64_t r = rank(placed.data());
+
+                        if(not(seen[r * cells + id])) {
+                            const std::uint64_t moved = occupied ^ 
+                                                        (std::uint64_t(1) << id) ^ 
+                                                        (std::uint64_t(1) << blank);
+                            mark(r, flood(moved, id));
+                            table[r] = std::min<std::uint8_t>(table[r], depth + 1);
+                            next.push_back(pack(placed, id));
+                        }
+
+                        placed[j] = id;
+                    }
+                }
+
+                for(int i = 0; i < k; ++i) {
+                    owner[placed[i]] = -1;
+                }
+            }
+
+            layer.swap(next);
+            next.clear();
+            ++depth;
+        }
+
+        packed.assign(bytes(), 0);
+        for(std::uint64_t r = 0; r < entries(); ++r) {
+            packed[r >> 1] |= half_excess(t, r, table[r]) << ((r & 1) * 4);
+        }
+    }
+
+    /// @brief the same search with delayed duplicate detection. A state 
+    /// is a placement rank times cells plus the least cell of the blank's 
+    /// region. Each layer is a sorted file: threads expand slices of it, 
+    /// buffering the successors, and sort and write them out as runs 
+    /// whenever their share of the memory fills up. Merging the runs, 
+    /// dropping the states of the layer and the one before it, which are 
+    /// the only ones a move leads back to, gives the next layer.
+    void build_external(const Target& t, const ExternalPdbBuild& options) {
+        const int k = tiles.size();
+        const int threads = std::max(1, options.threads);
+        const std::size_t share = std::max<std::size_t>(1 << 16, 
+                                                        options.memory / sizeof(std::uint64_t) / threads);
+        const std::string prefix = options.dir + "/pdb-" + std::to_string(::getpid()) + "-" + 
+                                   std::to_string(builds++) + "-";
+        auto layer_path = [&prefix](int depth) {
+            return prefix + "layer" + std::to_string(depth);
+        };
+
+        std::vector<std::uint8_t> seen((entries() + 7) / 8, 0); // placements reached
+        packed.assign(bytes(), 0);
+
+        auto reach = [&](std::uint64_t r, int depth) {
+            if(not(seen[r >> 3] >> (r & 7) & 1)) {
+                seen[r >> 3] |= 1 << (r & 7);
+                packed[r >> 1] |= half_excess(t, r, depth) << ((r & 1) * 4);
+            }
+        };
+
+        std::vector<int> placed(k);
+        std::uint64_t occupied{0};
+        for(int i = 0; i < k; ++i) {
+            placed[i] = t.goal(tiles[i]);
+            occupied |= std::uint64_t(1) << placed[i];
+        }
+
+        const std::uint64_t start = rank(placed.data());
+        reach(start, 0);
+        IntFileWriter first(layer_path(0));
+        first.push(start * cells + __builtin_ctzll(flood(occupied, t.goal(0))));
+        std::uint64_t size = first.close();
+
+        std::vector<std::string> files{layer_path(0)}; // removed at the end, also on errors
+        try {
+            for(int depth = 0; size; ++depth) {
+                // expand
+                std::vector<std::vector<std::string>> runs(threads);
+                std::vector<std::exception_ptr> errors(threads);
+                std::vector<std::thread> workers;
+
+                for(int w = 0; w < threads; ++w) {
+                    workers.emplace_back([&, w]() {
+                        try {
+                            expand_slice(layer_path(depth), size * w / threads, size * (w + 1) / threads,
+                                         share, prefix + "run" + std::to_string(depth) + "-" + 
+                                                std::to_string(w) + "-", runs[w]);
+                        } catch(...) {
+                            errors[w] = std::current_exception();
+                        }
+                    });
+                }
+                for(std::thread& worker: workers) {
+                    worker.join();
+                }
+                for(const std::vector<std::string>& r: runs) {
+                    files.insert(files.end(), r.begin(), r.end());
+                }
+                for(const std::exception_ptr& e: errors) {
+                    if(e) {
+                        std::rethrow_exception(e);
+                    }
+                }
+
+                // merge
+                std::vector<IntFileReader> readers;
+                for(const std::vector<std::string>& r: runs) {
+                    for(const std::string& path: r) {
+                        readers.emplace_back(path);
+                    }
+                }
+                IntFileReader current(layer_path(depth));
+                std::unique_ptr<IntFileReader> previous;
+                if(depth > 0) {
+                    previous = std::make_unique<IntFileReader>(layer_path(depth - 1));
+                }
+
+                using Head = std::pair<std::uint64_t, std::size_t>; // state, reader
+                std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+                for(std::size_t i = 0; i < readers.size(); ++i) {
+                    if(not(readers[i].empty())) {
+                        heads.emplace(readers[i].front(), i);
+                    }
+                }
+
+                files.push_back(layer_path(depth + 1));
+                IntFileWriter next(layer_path(depth + 1));
+                bool any{false};
+                std::uint64_t last{0};
+
+                while(not(heads.empty())) {
+                    const auto [state, i] = heads.top();
+                    heads.pop();
+                    readers[i].pop();
+                    if(not(readers[i].empty())) {
+                        heads.emplace(readers[i].front(), i);
+                    }
+
+                    if(any && state == last) {
+                        continue;
+                    }
+                    any = true;
+                    last = state;
+
+                    auto known = [state](IntFileReader* layer) {
+                        while(layer && not(layer->empty()) && layer->front() < state) {
+                            layer->pop();
+                        }
+                        return layer && not(layer->empty()) && layer->front() == state;
+                    };
+                    if(known(&current) || known(previous.get())) {
+                        continue;
+                    }
+
+                    next.push(state);
+                    reach(state / cells, depth + 1);
+                }
+
+                size = next.close();
+                readers.clear();
+                for(const std::vector<std::string>& r: runs) {
+                    for(const std::string& path: r) {
+                        std::remove(path.c_str());
+                    }
+                }
+                if(depth > 0) {
+                    previous.reset();
+                    std::remove(layer_path(depth - 1).c_str());
+                }
+            }
+        } catch(...) {
+            for(const std::string& path: files) {
+                std::remove(path.c_str());
+            }
+            throw;
+        }
+
+        for(const std::string& path: files) {
+            std::remove(path.c_str());
+        }
+
+        // unreachable placements, when the pattern has every tile, as build leaves them
+        for(std::uint64_t r = 0; r < entries(); ++r) {
+            if(not(seen[r >> 3] >> (r & 7) & 1)) {
+                packed[r >> 1] |= half_excess(t, r, UNSEEN) << ((r & 1) * 4);
+            }
+        }
+    }
+
+    /// @brief expands the states [begin, end) of a layer file, 
+    /// writing the successors to sorted runs of up to `share` states
+    void expand_slice(const std::string& layer, std::uint64_t begin, std::uint64_t end,
+                      std::size_t share, const std::string& prefix, 
+                      std::vector<std::string>& runs) const {
+        const int k = tiles.size();
+        std::vector<std::uint64_t> buffer;
+        buffer.reserve(share);
+        int placed[64];
+        int owner[64];
+        std::fill(owner, owner + cells, -1);
+
+        auto flush = [&]() {
+            std::sort(buffer.begin(), buffer.end());
+            buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+
+            runs.push_back(prefix + std::to_string(runs.size()));
+            IntFileWriter run(runs.back());
+            for(const std::uint64_t state: buffer) {
+                run.push(state);
+            }
+            run.close();
+            buffer.clear();
+        };
+
+        for(IntFileReader in(layer, begin, end); not(in.empty()); in.pop()) {
+            const std::uint64_t state = in.front();
+            unrank(state / cells, placed);
+
+            std::uint64_t occupied{0};
+            for(int i = 0; i < k; ++i) {
+                owner[placed[i]] = i;
+                occupied |= std::uint64_t(1) << placed[i];
+            }
+
+            for(std::uint64_t region = flood(occupied, state % cells); region; region &= region - 1) {
+                const int blank = __builtin_ctzll(region);
+
+                for(std::uint64_t near = adjacent[blank] & occupied; near; near &= near - 1) {
+                    // the pattern tile on cell id slides onto the blank
+                    const int id = __builtin_ctzll(near);
+                    const int j = owner[id];
+
+                    placed[j] = blank;
+                    const std::uint64_t moved = occupied ^ (std::uint64_t(1) << id) ^ 
+                                                (std::uint64_t(1) << blank);
+                    buffer.push_back(rank(placed) * cells + __builtin_ctzll(flood(moved, id)));
+                    placed[j] = id;
+
+                    if(buffer.size() == share) {
+                        flush();
+                    }
+                }
+            }
+
+            for(int i = 0; i < k; ++i) {
+                owner[placed[i]] = -1;
+            }
+        }
+
+        if(not(buffer.empty())) {
+            flush();
+        }
+    }
+
+};
+
+
+/// @brief On-disk layout of an AdditivePdb, mapped read-only by the solver:
+/// a PdbFileHeader, one PdbFilePattern per pattern, then the packed 
+/// entries of each pattern at 64-byte aligned offsets.
+/// The tables depend on the goal, so the header keys them on its blank cell.
+struct PdbFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t dim;
+    std::uint32_t zero_id; // goal blank cell
+    std::uint32_t patterns;
+    std::uint32_t reserved[10];
+
+    static inline const char MAGIC[8] = "NPZLPDB";
+    static inline const std::uint32_t VERSION = 1;
+};
+
+struct PdbFilePattern {
+    std::uint64_t offset; // of the packed entries, from the start of the file
+    std::uint64_t bytes;
+    std::uint8_t size; // number of tiles
+    std::uint8_t tiles[15];
+};
+
+static_assert(sizeof(PdbFileHeader) == 64, "PdbFileHeader layout changed");
+static_assert(sizeof(PdbFilePattern) == 32, "PdbFilePattern layout changed");
+
+
+/// @brief Disjoint patterns covering all tiles, their values add up 
+/// to an admissible heuristic
+struct AdditivePdb {
+
+    /// @brief maps the tables from the file at path if it exists,
+    /// otherwise builds them and saves them there for later runs
+    /// @param partition pattern sizes, e.g. "6-6-3", empty to take the
+    /// file's partition or the default one of the board size
+    /// @param external how to build the tables on disk, null to build them in memory
+    static std::unique_ptr<AdditivePdb> open(const Target& t,
+                                             const std::string& partition,
+                                             const std::string& path,
+                                             const ExternalPdbBuild* external = nullptr) {
+        if(not(path.empty()) && MappedFile::exists(path)) {
+            std::unique_ptr<AdditivePdb> pdb(new AdditivePdb(t, std::make_unique<MappedFile>(path)));
+            
+            if(not(partition.empty()) && partition != pdb->partition()) {
+                throw std::runtime_error(path + " holds partition " + pdb->partition() + 
+                                         ", not " + partition);
+            }
+            return pdb;
+        }
+
+        auto pdb = std::make_unique<AdditivePdb>(t, partition.empty() ? 
+                                                    default_partition(std::sqrt(t.size())) : 
+                                                    partition,
+                                                 external);
+        if(not(path.empty())) {
+            pdb->save(t, path);
+        }
+        return pdb;
+    }
+
+    /// @param partition pattern sizes, e.g. "6-6-3"; tiles are grouped 
+    /// in row-major order of their goal cells
+    AdditivePdb(const Target& t, const std::string& partition, 
+                const ExternalPdbBuild* external = nullptr):
+        owner(t.size(), -1) {
+
+        std::vector<int> sizes = parse(partition);
+        
+        int total{0};
+        for(int k: sizes) {
+            total += k;
+        }
+        if(total != t.size() - 1) {
+            throw std::runtime_error("Partition " + partition + " does not cover all tiles!");
+        }
+
+        std::vector<int> order(t.size() - 1); // tiles by goal cell
+        for(int tile = 1; tile < t.size(); ++tile) {
+            order[tile - 1] = tile;
+        }
+        std::sort(order.begin(), order.end(), [&t](int a, int b) {
+            return t.goal(a) < t.goal(b);
+        });
+
+        auto next = order.begin();
+        for(int k: sizes) {
+            if(k > MAX_PATTERN || t.size() > 64) {
+                throw std::runtime_error("Pattern of " + std::to_string(k) + 
+                                         " tiles is too large!");
+            }
+
+            std::vector<int> tiles(next, next + k);
+            next += k;
+
+            for(int tile: tiles) {
+                owner[tile] = patterns.size();
+            }
+            if(external) {
+                patterns.emplace_back(t, tiles, *external);
+            } else {
+                patterns.emplace_back(t, tiles);
+            }
+        }
+    }
+
+    static inline const int MAX_PATTERN = 9; // placements are packed in 6-bit fields
+
+    static std::string default_partition(int dim) {
+        switch(dim) {
+            case 3: return "4-4";
+            case 4: return "6-6-3";
+            case 5: return "6-6-6-6";
+            default:
+                throw std::runtime_error("No default pattern partition for this board size!");
+        }
+    }
+
+    std::string partition() const {
+        std::string sizes;
+        for(const PatternDatabase& p: patterns) {
+            sizes += (sizes.empty() ? "" : "-") + std::to_string(p.tiles.size());
+        }
+        return sizes;
+    }
+
+    /// @brief writes the file format read by open, through a temporary 
+    /// file renamed into place so that concurrent readers never see it half-written
+    void save(const Target& t, const std::string& path) const {
+        PdbFileHeader header{};
+        std::memcpy(header.magic, PdbFileHeader::MAGIC, sizeof(header.magic));
+        header.version = PdbFileHeader::VERSION;
+        header.dim = std::sqrt(t.size());
+        header.zero_id = t.goal(0);
+        header.patterns = patterns.size();
+
+        std::vector<PdbFilePattern> index(patterns.size());
+        std::uint64_t offset = sizeof(header) + index.size() * sizeof(PdbFilePattern);
+
+        for(std::size_t i = 0; i < patterns.size(); ++i) {
+            offset = (offset + 63) / 64 * 64;
+            index[i] = PdbFilePattern{};
+            index[i].offset = offset;
+            index[i].bytes = patterns[i].bytes();
+            index[i].size = patterns[i].tiles.size();
+            std::copy(patterns[i].tiles.begin(), patterns[i].tiles.end(), index[i].tiles);
+            offset += index[i].bytes;
+        }
+
+        const std::string tmp = path + ".tmp" + std::to_string(::getpid());
+        std::ofstream os(tmp, std::ios::binary);
+
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(PdbFilePattern));
+
+        for(std::size_t i = 0; i < patterns.size(); ++i) {
+            const std::string padding(index[i].offset - os.tellp(), '\0');
+            os.write(padding.data(), padding.size());
+            os.write(reinterpret_cast<const char*>(patterns[i].nibbles()), index[i].bytes);
+        }
+        os.close();
+
+        if(not(os) || std::rename(tmp.c_str(), path.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            throw std::runtime_error("Cannot write " + path);
+        }
+    }
+
+    std::vector<PatternDatabase> patterns;
+    std::vector<int> owner; // tile -> index in patterns
+
+private:
+
+    std::unique_ptr<MappedFile> file; // backs the patterns, if mapped
+
+    /// @brief views of the tables in a mapped file, checked against the target
+    AdditivePdb(const Target& t, std::unique_ptr<MappedFile> mapped):
+        owner(t.size(), -1),
+        file(std::move(mapped)) {
+
+        const std::string invalid = "Invalid pattern database file: ";
+        PdbFileHeader header;
+
+        if(file->size < sizeof(header)) {
+            throw std::runtime_error(invalid + "too short");
+        }
+        std::memcpy(&header, file->data, sizeof(header));
+
+        if(std::memcmp(header.magic, PdbFileHeader::MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error(invalid + "bad magic");
+        }
+        if(header.version != PdbFileHeader::VERSION) {
+            throw std::runtime_error(invalid + "version " + std::to_string(header.version) + 
+                                     ", expected " + std::to_string(PdbFileHeader::VERSION));
+        }
+        if(header.dim * header.dim != std::uint32_t(t.size()) || 
+           header.zero_id != std::uint32_t(t.goal(0))) {
+            throw std::runtime_error(invalid + "built for another board or goal blank position");
+        }
+        if(file->size < sizeof(header) + header.patterns * sizeof(PdbFilePattern)) {
+            throw std::runtime_error(invalid + "truncated index");
+        }
+
+        for(std::uint32_t i = 0; i < header.patterns; ++i) {
+            PdbFilePattern p;
+            std::memcpy(&p, file->data + sizeof(header) + i * sizeof(p), sizeof(p));
+
+            if(p.size > MAX_PATTERN) {
+                throw std::runtime_error(invalid + "pattern too large");
+            }
+
+            std::vector<int> tiles(p.tiles, p.tiles + p.size);
+            for(int tile: tiles) {
+                if(tile <= 0 || tile >= t.size() || owner[tile] != -1) {
+                    throw std::runtime_error(invalid + "patterns are not disjoint");
+                }
+                owner[tile] = patterns.size();
+            }
+
+            patterns.emplace_back(t, tiles, file->data + p.offset);
+            if(p.offset % 64 || p.bytes != patterns.back().bytes() || 
+               p.offset + p.bytes > file->size) {
+                throw std::runtime_error(invalid + "truncated entries");
+            }
+        }
+
+        if(std::count(owner.begin() + 1, owner.end(), -1)) {
+            throw std::runtime_error(invalid + "patterns do not cover all tiles");
+        }
+    }
+
+    static std::vector<int> parse(const std::string& partition) {
+        std::vector<int> sizes;
+        std::size_t begin{0};
+
+        while(begin <= partition.size()) {
+            std::size_t end = partition.find('-', begin);
+            if(end == std::string::npos) {
+                end = partition.size();
+            }
+
+            const std::string k = partition.substr(begin, end - begin);
+            if(k.empty() || k.find_first_not_of("0123456789") != std::string::npos ||
+               std::stoi(k) < 1) {
+                throw std::runtime_error("Invalid pattern partition " + partition);
+            }
+
+            sizes.push_back(std::stoi(k));
+            begin = end + 1;
+        }
+
+        return sizes;
+    }
+
+};
+
+
+/// @brief Walking distance tables. Along one axis, a state counts for 
+/// every line how many of its tiles belong to each goal line, plus the 
+/// line of the blank. Its distance is the least number of moves along 
+/// the axis that sorts all tiles into their goal lines. 
+/// The vertical and horizontal distances add up to an admissible heuristic.
+struct WalkingDistance {
+
+    static inline const int MAX_DIM = 4; // counts are packed in 3-bit fields
+
+    struct Table {
+
+        /// @param blank_line the line of the goal blank cell
+        Table(int dim, int blank_line);
+
+        /// @param lines lines[i] is the goal line of the tile on the i-th cell 
+        /// of the line, in line order; -1 for the blank
+        int id(const std::vector<int>& lines) const;
+
+        /// @brief the state after a tile of goal line `type` moves 
+        /// one line `forward` (towards higher lines) or back 
+        int next(int id, bool forward, int type) const {
+            return transitions[(id * 2 + forward) * dim + type];
+        }
+
+        int dim;
+        std::vector<std::uint8_t> distances; // by id
+        std::vector<int> transitions; // [id][forward][type], -1 if impossible
+        std::unordered_map<std::uint64_t, int> ids; // state key -> id
+    };
+
+    explicit WalkingDistance(const Target& t):
+        dim(std::sqrt(t.size())),
+        vertical((check(dim), dim), t.goal(0) / dim),
+        horizontal(dim, t.goal(0) % dim) {
+    }
+
+    int dim;
+    Table vertical; // lines are rows
+    Table horizontal; // lines are columns
+
+private:
+    static void check(int dim) {
+        if(dim > MAX_DIM) {
+            throw std::runtime_error("Walking distance is only available up to " + 
+                                     std::to_string(MAX_DIM) + "x" + 
+                                     std::to_string(MAX_DIM) + " boards!");
+        }
+    }
+};
+
+
+WalkingDistance::Table::Table(int dim, int blank_line): dim(dim) {
+    // key: count of tiles of goal line j in line i in bits [3(i * dim + j), +3),
+    // the blank line above them
+    const int blank_shift = 3 * dim * dim;
+    auto count = [](std::uint64_t key, int field) {
+        return int(key >> (3 * field) & 0x7);
+    };
+
+    std::uint64_t goal = std::uint64_t(blank_line) << blank_shift;
+    for(int i = 0; i < dim; ++i) {
+        goal |= std::uint64_t(i == blank_line ? dim - 1 : dim) << (3 * (i * dim + i));
+    }
+
+    std::vector<std::uint64_t> keys{goal}; // by id, in breadth-first order
+    ids[goal] = 0;
+    distances.push_back(0);
+
+    for(std::size_t id = 0; id < keys.size(); ++id) {
+        const std::uint64_t key = keys[id];
+        const int blank = key >> blank_shift;
+
+        transitions.resize(keys.size() * 2 * dim, -1);
+
+        for(const bool forward: {false, true}) {
+            // a tile moving forward comes from the line before the blank
+            const int line = forward ? blank - 1 : blank + 1;
+            if(line < 0 || line >= dim) {
+                continue;
+            }
+
+            for(int type = 0; type < dim; ++type) {
+                if(not(count(key, line * dim + type))) {
+                    continue;
+                }
+
+                std::uint64_t succ = key - (std::uint64_t(1) << (3 * (line * dim + type)))
+                                         + (std::uint64_t(1) << (3 * (blank * dim + type)));
+                succ = (succ & ~(std::uint64_t(0x7) << blank_shift)) | 
+                       (std::uint64_t(line) << blank_shift);
+
+                auto found = ids.find(succ);
+                if(found == ids.end()) {
+                    found = ids.emplace(succ, keys.size()).first;
+                    keys.push_back(succ);
+                    distances.push_back(distances[id] + 1);
+                }
+
+                transitions[(id * 2 + forward) * dim + type] = found->second;
+            }
+        }
+    }
+
+    transitions.resize(keys.size() * 2 * dim, -1);
+}
+
+
+int WalkingDistance::Table::id(const std::vector<int>& lines) const {
+    std::uint64_t key{0};
+
+    for(int i = 0; i < dim * dim; ++i) {
+        if(lines[i] < 0) {
+            key |= std::uint64_t(i / dim) << (3 * dim * dim);
+        } else {
+            key += std::uint64_t(1) << (3 * (i / dim * dim + lines[i]));
+        }
+    }
+    return ids.at(key);
+}
+
+
+/// @brief Exact distances to the goal of all the 8-puzzle states, a byte 
+/// each, found by a breadth-first search back from the goal. A state is 
+/// ranked by its blank cell and the Lehmer rank of its tiles in reading 
+/// order, halved: the ranks 2k and 2k + 1 differ by a swap of the last two 
+/// tiles, which changes the parity of the tiles, and on a board 3 wide no 
+/// move does. So exactly the 9 * 8! / 2 reachable states get an entry.
+struct DistanceTable {
+
+    static constexpr int DIM = 3;
+    static constexpr int CELLS = DIM * DIM;
+    static constexpr int PERMUTATIONS = 20160; // of the tiles with one parity, 8! / 2
+    static constexpr std::uint8_t UNSEEN = 0xFF;
+
+    explicit DistanceTable(const Target& t);
+
+    static int rank(const PackedBoard<DIM>& b) {
+        unsigned seen{0}; // tiles met so far
+        int left{CELLS - 1}; // tiles not met yet
+        int r{0};
+
+        for(int i = 0; i < CELLS; ++i) {
+            const int tile = b.at(i);
+            if(tile) {
+                // the tiles after it that are smaller
+                const int smaller = tile - 1 - ones[seen & ((1u << tile) - 1)];
+                r = r * left-- + smaller;
+                seen |= 1u << tile;
+            }
+        }
+
+        return b.zero_id * PERMUTATIONS + r / 2;
+    }
+
+    int distance(const PackedBoard<DIM>& b) const {
+        return distances[rank(b)];
+    }
+
+private:
+
+    static constexpr std::array<std::uint8_t, 1 << CELLS> make_ones() {
+        std::array<std::uint8_t, 1 << CELLS> ones{};
+        for(int set = 1; set < 1 << CELLS; ++set) {
+            ones[set] = ones[set >> 1] + (set & 1);
+        }
+        return ones;
+    }
+
+    static const std::array<std::uint8_t, 1 << CELLS> ones; // of each set of tiles
+
+    std::vector<std::uint8_t> distances; // by rank
+};
+
+
+const std::array<std::uint8_t, 1 << DistanceTable::CELLS> DistanceTable::ones = DistanceTable::make_ones();
+
+
+DistanceTable::DistanceTable(const Target& t): 
+    distances(CELLS * PERMUTATIONS, UNSEEN) {
+
+    if(t.size() != CELLS) {
+        throw std::runtime_error("The distance table is for 8-puzzles only!");
+    }
+
+    dict positions = t.posistions;
+    Board b(DIM, positions);
+    for(int tile = 0; tile < CELLS; ++tile) {
+        b.tiles[t.goal(tile) / DIM][t.goal(tile) % DIM] = tile;
+    }
+    b.zero_id = t.goal(0);
+
+    std::queue<PackedBoard<DIM>> open;
+    open.emplace(b);
+    distances[rank(open.front())] = 0;
+
+    while(not(open.empty())) {
+        const PackedBoard<DIM> current = open.front();
+        const int d = distances[rank(current)];
+        open.pop();
+
+        for(int m = 0; m < 4; ++m) {
+            PackedBoard<DIM> next = current;
+            if(next.apply_move(m)) {
+                std::uint8_t& entry = distances[rank(next)];
+                if(entry == UNSEEN) {
+                    entry = d + 1;
+                    open.push(next);
+                }
+            }
+        }
+    }
+}
+
+
+enum class Heuristic {
+    MANHATTAN,
+    PDB,
+    LINEAR_CONFLICT,
+    WALKING_DISTANCE,
+};
+
+
+/// @brief Heuristic evaluators used by the search. 
+/// init computes h of the root, apply updates h after a tile slid 
+/// from cell `from` to cell `to`, undo reverts any internal state.
+struct ManhattanEvaluator {
+
+    const Target& target;
+
+    template<typename B>
+    int init(const B& b) {
+        return target.manhattan(b);
+    }
+
+    template<typename B>
+    int apply(const B&, int h, int tile, int from, int to) {
+        return h - target.distance(tile, from) + target.distance(tile, to);
+    }
+
+    void undo(int, int, int) {}
+};
+
+
+/// h is the Manhattan distance plus twice the sum of the pattern entries
+struct PdbEvaluator {
+
+    PdbEvaluator(const AdditivePdb& pdb, const Target& target): 
+        pdb(pdb), 
+        target(target),
+        pos(pdb.owner.size()) {
+    }
+
+    template<typename B>
+    int init(const B& b) {
+        for(int i = 0; i < int(pos.size()); ++i) {
+            pos[b.at(i)] = i;
+        }
+
+        int h = target.manhattan(b);
+        for(const PatternDatabase& p: pdb.patterns) {
+            h += 2 * p.value(pos);
+        }
+        return h;
+    }
+
+    /// only the pattern owning the tile changes its value
+    template<typename B>
+    int apply(const B&, int h, int tile, int from, int to) {
+        const PatternDatabase& p = pdb.patterns[pdb.owner[tile]];
+        h += target.distance(tile, to) - target.distance(tile, from) - 2 * p.value(pos);
+        pos[tile] = to;
+        return h + 2 * p.value(pos);
+    }
+
+    void undo(int tile, int from, int) {
+        pos[tile] = from;
+    }
+
+    const AdditivePdb& pdb;
+    const Target& target;
+    std::vector<int> pos; // tile -> cell
+};
+
+
+/// h is the Manhattan distance plus 2 moves for each tile that has to 
+/// leave its goal line to let the others in it pass, kept per line.
+/// A tile sliding along a column leaves the columns untouched, so a move 
+/// recounts just the two rows it affects, and vice versa.
+struct LinearConflictEvaluator {
+
+    LinearConflictEvaluator(const Target& target):
+        target(target),
+        dim(std::sqrt(target.size())),
+        conflicts(2 * dim, 0) {
+    }
+
+    template<typename B>
+    int init(const B& b) {
+        int h = target.manhattan(b);
+        for(int line = 0; line < 2 * b.size(); ++line) {
+            conflicts[line] = count(b, line);
+            h += 2 * conflicts[line];
+        }
+        return h;
+    }
+
+    template<typename B>
+    int apply(const B& b, int h, int tile, int from, int to) {
+        h += target.distance(tile, to) - target.distance(tile, from);
+
+        for(const int line: lines(b.size(), from, to)) {
+            const int c = count(b, line);
+            saved.push_back(conflicts[line]);
+            h += 2 * (c - conflicts[line]);
+            conflicts[line] = c;
+        }
+        return h;
+    }
+
+    void undo(int, int from, int to) {
+        const std::array<int, 2> changed = lines(dim, from, to);
+        for(auto line = changed.rbegin(); line != changed.rend(); ++line) {
+            conflicts[*line] = saved.back();
+            saved.pop_back();
+        }
+    }
+
+    const Target& target;
+    int dim;
+    std::vector<int> conflicts; // rows, then columns
+    FixedStack<std::uint8_t, 2 * MAX_SOLUTION_LENGTH> saved; // undo stack, two lines a move
+
+private:
+
+    /// @brief lines 0..dim-1 are rows, dim..2dim-1 columns
+    std::array<int, 2> lines(int dim, int from, int to) const {
+        if(from % dim == to % dim) { // vertical move
+            return {from / dim, to / dim};
+        }
+        return {dim + from % dim, dim + to % dim};
+    }
+
+    /// @brief the least number of tiles to take out of the line so 
+    /// that the rest of its goal tiles are in order, len - LIS
+    template<typename B>
+    int count(const B& b, int line) const {
+        int order[64]; // goal positions along the line, of tiles at home in it
+        int best[64];  // LIS ending at each
+        int len{0};
+        int longest{0};
+        const int dim = b.size(); // a constant for the fixed-size boards
+
+        for(int i = 0; i < dim; ++i) {
+            const int id = line < dim ? line * dim + i : i * dim + line - dim;
+            const int tile = b.at(id);
+            if(not(tile)) {
+                continue;
+            }
+
+            const int goal = target.goal(tile);
+            if(line < dim ? goal / dim != line : goal % dim != line - dim) {
+                continue;
+            }
+
+            order[len] = line < dim ? goal % dim : goal / dim;
+            best[len] = 1;
+            for(int j = 0; j < len; ++j) {
+                if(order[j] < order[len]) {
+                    best[len] = std::max(best[len], best[j] + 1);
+                }
+            }
+            longest = std::max(longest, best[len]);
+            ++len;
+        }
+
+        return len - longest;
+    }
+};
+
+
+/// @brief Manhattan distance plus linear conflicts, the h of 
+/// LinearConflictEvaluator::init, of many packed boards at once. 
+/// A board is unpacked to a byte per cell in a 16-byte register and 
+/// every per-cell value is a byte shuffle of a table indexed by tile. 
+/// The tiles at home in a line are keyed by their goal positions along 
+/// it, 3 bits a cell, and their conflicts looked up by the key. 
+/// The widest kernel the CPU supports is picked at runtime, all of 
+/// them give the same values.
+template<int DIM>
+struct BatchEvaluator {
+
+    static_assert(DIM >= 2 && DIM <= MAX_PACKED_DIM, "the boards are unpacked to 16 bytes");
+
+    static constexpr int CELLS = DIM * DIM;
+    static constexpr int KEYS = 1 << 12; // of a line, 4 cells of 3 bits
+    static constexpr std::uint8_t NONE = 0x80; // a shuffle index that yields 0
+
+    enum class Kernel {
+        SCALAR,
+        SSSE3,
+        AVX2,
+    };
+
+    explicit BatchEvaluator(const Target& t, Kernel kernel = best_kernel()):
+        kernel(kernel) {
+
+        assert(t.size() == CELLS);
+
+        for(int tile = 1; tile < CELLS; ++tile) {
+            goal_row[tile] = t.goal(tile) / DIM;
+            goal_col[tile] = t.goal(tile) % DIM;
+        }
+
+        for(int i = 0; i < 16; ++i) {
+            const int line = i / 4;
+            const int k = i % 4;
+            cell_row[i] = i < CELLS ? i / DIM : 0;
+            cell_col[i] = i < CELLS ? i % DIM : 0;
+            row_slots[i] = line < DIM && k < DIM ? line * DIM + k : NONE;
+            col_slots[i] = line < DIM && k < DIM ? k * DIM + line : NONE;
+        }
+
+        // a cell of a key is 0 if no tile at home is on it, its goal position + 1 otherwise
+        for(int key = 0; key < KEYS; ++key) {
+            int order[4];
+            int best[4];
+            int len{0};
+            int longest{0};
+
+            for(int k = 0; k < 4; ++k) {
+                const int cell = (key >> (3 * k)) & 7;
+                if(cell) {
+                    order[len] = cell;
+                    best[len] = 1;
+                    for(int j = 0; j < len; ++j) {
+                        if(order[j] < order[len]) {
+                            best[len] = std::max(best[len], best[j] + 1);
+                        }
+                    }
+                    longest = std::max(longest, best[len]);
+                    ++len;
+                }
+            }
+            conflicts[key] = len - longest;
+        }
+    }
+
+    /// @brief h[i] = h of boards[i], for i < count
+    void evaluate(const PackedBoard<DIM>* boards, int count, int* h) const {
+        int i{0};
+
+#ifdef BATCH_SIMD
+        if(kernel == Kernel::AVX2) {
+            for(; i + 2 <= count; i += 2) {
+                evaluate_avx2(boards[i].tiles, boards[i + 1].tiles, h + i);
+            }
+        }
+        if(kernel != Kernel::SCALAR) {
+            for(; i < count; ++i) {
+                h[i] = evaluate_ssse3(boards[i].tiles);
+            }
+        }
+#endif
+
+        for(; i < count; ++i) {
+            h[i] = evaluate_scalar(boards[i].tiles);
+        }
+    }
+
+    static Kernel best_kernel() {
+#ifdef BATCH_SIMD
+        if(__builtin_cpu_supports("avx2")) {
+            return Kernel::AVX2;
+        }
+        if(__builtin_cpu_supports("ssse3")) {
+            return Kernel::SSSE3;
+        }
+#endif
+        return Kernel::SCALAR;
+    }
+
+    static bool supported(Kernel kernel) {
+        return kernel <= best_kernel();
+    }
+
+    static const char* name(Kernel kernel) {
+        switch(kernel) {
+            case Kernel::AVX2: return "avx2";
+            case Kernel::SSSE3: return "ssse3";
+            default: return "scalar";
+        }
+    }
+
+    Kernel kernel;
+
+private:
+
+    int evaluate_scalar(std::uint64_t tiles) const {
+        int h{0};
+        int rows[4]{}; // keys of the lines
+        int cols[4]{};
+
+        for(int i = 0; i < CELLS; ++i) {
+            const int tile = (tiles >> (4 * i)) & 0xF;
+            if(not(tile)) {
+                continue;
+            }
+
+            const int row = cell_row[i];
+            const int col = cell_col[i];
+            h += std::abs(goal_row[tile] - row) + std::abs(goal_col[tile] - col);
+
+            if(goal_row[tile] == row) {
+                rows[row] |= (goal_col[tile] + 1) << (3 * col);
+            }
+            if(goal_col[tile] == col) {
+                cols[col] |= (goal_row[tile] + 1) << (3 * row);
+            }
+        }
+
+        for(int line = 0; line < DIM; ++line) {
+            h += 2 * (conflicts[rows[line]] + conflicts[cols[line]]);
+        }
+        return h;
+    }
+
+#ifdef BATCH_SIMD
+
+    __attribute__((target("ssse3")))
+    static __m128i load(const std::array<std::uint8_t, 16>& bytes) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes.data()));
+    }
+
+    /// @brief the tile of cell i in byte i
+    __attribute__((target("ssse3")))
+    static __m128i unpack(std::uint64_t tiles) {
+        const __m128i nibble = _mm_set1_epi8(0xF);
+        const __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&tiles)); // also on 32-bit x86
+        return _mm_unpacklo_epi8(_mm_and_si128(x, nibble), 
+                                 _mm_and_si128(_mm_srli_epi16(x, 4), nibble));
+    }
+
+    __attribute__((target("ssse3")))
+    static __m128i absdiff(__m128i a, __m128i b) {
+        return _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+    }
+
+    /// @brief the keys of 4 lines of 4 cells, as 32-bit integers
+    __attribute__((target("ssse3")))
+    static __m128i keys(__m128i cells) {
+        const __m128i pairs = _mm_maddubs_epi16(cells, _mm_set1_epi16(0x0801)); // c0 + 8 c1
+        return _mm_madd_epi16(pairs, _mm_set1_epi32(0x00400001)); // + 64 (c2 + 8 c3)
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i absdiff(__m256i a, __m256i b) {
+        return _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i keys(__m256i cells) {
+        const __m256i pairs = _mm256_maddubs_epi16(cells, _mm256_set1_epi16(0x0801));
+        return _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00400001));
+    }
+
+    __attribute__((target("ssse3")))
+    int evaluate_ssse3(std::uint64_t tiles) const {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi8(1);
+        const __m128i cell_rows = load(cell_row);
+        const __m128i cell_cols = load(cell_col);
+
+        const __m128i tile = unpack(tiles);
+        const __m128i blank = _mm_cmpeq_epi8(tile, zero); // and the padding of smaller boards
+        const __m128i rows = _mm_shuffle_epi8(load(goal_row), tile);
+        const __m128i cols = _mm_shuffle_epi8(load(goal_col), tile);
+
+        const __m128i distances = _mm_andnot_si128(blank, _mm_add_epi8(absdiff(rows, cell_rows), 
+                                                                       absdiff(cols, cell_cols)));
+        const __m128i sums = _mm_sad_epu8(distances, zero);
+
+        // goal position + 1 of the tiles at home in their line, 0 for the other cells
+        const __m128i in_row = _mm_andnot_si128(blank, _mm_cmpeq_epi8(rows, cell_rows));
+        const __m128i in_col = _mm_andnot_si128(blank, _mm_cmpeq_epi8(cols, cell_cols));
+        const __m128i row_cells = _mm_shuffle_epi8(_mm_and_si128(in_row, _mm_add_epi8(cols, one)), 
+                                                   load(row_slots));
+        const __m128i col_cells = _mm_shuffle_epi8(_mm_and_si128(in_col, _mm_add_epi8(rows, one)), 
+                                                   load(col_slots));
+
+        alignas(16) int line_keys[8];
+        _mm_store_si128(reinterpret_cast<__m128i*>(line_keys), keys(row_cells));
+        _mm_store_si128(reinterpret_cast<__m128i*>(line_keys + 4), keys(col_cells));
+
+        int h = _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+        for(const int key: line_keys) {
+            h += 2 * conflicts[key];
+        }
+        return h;
+    }
+
+    /// @brief two boards a register, one in each 128-bit lane, 
+    /// and the conflicts gathered for all their lines at once
+    __attribute__((target("avx2")))
+    void evaluate_avx2(std::uint64_t first, std::uint64_t second, int* h) const {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi8(1);
+        const __m256i cell_rows = _mm256_broadcastsi128_si256(load(cell_row));
+        const __m256i cell_cols = _mm256_broadcastsi128_si256(load(cell_col));
+
+        const __m256i tile = _mm256_inserti128_si256(_mm256_castsi128_si256(unpack(first)), 
+                                                     unpack(second), 1);
+        const __m256i blank = _mm256_cmpeq_epi8(tile, zero);
+        const __m256i rows = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(load(goal_row)), tile);
+        const __m256i cols = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(load(goal_col)), tile);
+
+        const __m256i distances = _mm256_andnot_si256(blank, _mm256_add_epi8(absdiff(rows, cell_rows), 
+                                                                             absdiff(cols, cell_cols)));
+        const __m256i sums = _mm256_sad_epu8(distances, zero);
+
+        const __m256i in_row = _mm256_andnot_si256(blank, _mm256_cmpeq_epi8(rows, cell_rows));
+        const __m256i in_col = _mm256_andnot_si256(blank, _mm256_cmpeq_epi8(cols, cell_cols));
+        const __m256i row_cells = _mm256_shuffle_epi8(_mm256_and_si256(in_row, _mm256_add_epi8(cols, one)), 
+                                                      _mm256_broadcastsi128_si256(load(row_slots)));
+        const __m256i col_cells = _mm256_shuffle_epi8(_mm256_and_si256(in_col, _mm256_add_epi8(rows, one)), 
+                                                      _mm256_broadcastsi128_si256(load(col_slots)));
+
+        const __m256i line_conflicts = _mm256_add_epi32(
+            _mm256_i32gather_epi32(conflicts.data(), keys(row_cells), 4),
+            _mm256_i32gather_epi32(conflicts.data(), keys(col_cells), 4));
+
+        alignas(32) int c[8];
+        alignas(32) long long d[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(c), line_conflicts);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(d), sums);
+
+        h[0] = d[0] + d[1] + 2 * (c[0] + c[1] + c[2] + c[3]);
+        h[1] = d[2] + d[3] + 2 * (c[4] + c[5] + c[6] + c[7]);
+    }
+
+#endif
+
+    std::array<std::uint8_t, 16> goal_row{}; // by tile
+    std::array<std::uint8_t, 16> goal_col{};
+    std::array<std::uint8_t, 16> cell_row{}; // by cell
+    std::array<std::uint8_t, 16> cell_col{};
+    std::array<std::uint8_t, 16> row_slots{}; // shuffles the cells into lines of 4 slots
+    std::array<std::uint8_t, 16> col_slots{};
+    std::array<int, KEYS> conflicts{}; // of a line, by key
+};
+
+
+/// h is the sum of the vertical and horizontal walking distances, 
+/// a move advances one of the two table states
+struct WalkingDistanceEvaluator {
+
+    WalkingDistanceEvaluator(const WalkingDistance& wd, const Target& target):
+        wd(wd),
+        target(target) {
+    }
+
+    template<typename B>
+    int init(const B& b) {
+        const int dim = b.size();
+        std::vector<int> rows(dim * dim);
+        std::vector<int> cols(dim * dim);
+
+        for(int id = 0; id < dim * dim; ++id) {
+            const int tile = b.at(id);
+            const int goal = target.goal(tile);
+
+            // columns are read as rows of the transposed board
+            rows[id] = tile ? goal / dim : -1;
+            cols[id % dim * dim + id / dim] = tile ? goal % dim : -1;
+        }
+
+        vertical = wd.vertical.id(rows);
+        horizontal = wd.horizontal.id(cols);
+        return wd.vertical.distances[vertical] + wd.horizontal.distances[horizontal];
+    }
+
+    template<typename B>
+    int apply(const B& b, int, int tile, int from, int to) {
+        const int dim = b.size();
+        const int goal = target.goal(tile);
+
+        if(from % dim == to % dim) {
+            vertical = wd.vertical.next(vertical, to > from, goal / dim);
+        } else {
+            horizontal = wd.horizontal.next(horizontal, to > from, goal % dim);
+        }
+        return wd.vertical.distances[vertical] + wd.horizontal.distances[horizontal];
+    }
+
+    /// the tile moving back is the reverse transition
+    void undo(int tile, int from, int to) {
+        const int dim = wd.dim;
+        const int goal = target.goal(tile);
+
+        if(from % dim == to % dim) {
+            vertical = wd.vertical.next(vertical, from > to, goal / dim);
+        } else {
+            horizontal = wd.horizontal.next(horizontal, from > to, goal % dim);
+        }
+    }
+
+    const WalkingDistance& wd;
+    const Target& target;
+    int vertical{0}; // table states
+    int horizontal{0};
+};
+
+
+static constexpr int BEYOND_BOUND = INT_MAX / 4; // h of nodes no solution within the bound passes
+
+
+/// h of another evaluator times weight / 100, so that IDA* finds a 
+/// solution at most that many times costlier than the optimal one. 
+/// Nodes where no solution cheaper than `bound` passes get BEYOND_BOUND.
+template<typename H>
+struct WeightedEvaluator {
+
+    WeightedEvaluator(const H& eval, int weight, int bound = INT_MAX):
+        eval(eval),
+        weight(weight),
+        bound(bound) {
+    }
+
+    template<typename B>
+    int init(const B& b) {
+        inner.clear();
+        inner.push_back(eval.init(b));
+        return weigh();
+    }
+
+    template<typename B>
+    int apply(const B& b, int, int tile, int from, int to) {
+        inner.push_back(eval.apply(b, inner.back(), tile, from, to));
+        return weigh();
+    }
+
+    void undo(int tile, int from, int to) {
+        inner.pop_back();
+        eval.undo(tile, from, to);
+    }
+
+private:
+
+    int weigh() const {
+        const int h = inner.back();
+        const int g = inner.size() - 1;
+        return g + h >= bound ? BEYOND_BOUND : h * weight / 100;
+    }
+
+    H eval;
+    int weight; // percent
+    int bound;
+    FixedStack<int, MAX_SOLUTION_LENGTH + 1> inner; // h of eval along the path, the root first
+};
+
+
+/// @brief Finite-state automaton over move sequences that rejects a move 
+/// completing a duplicate: a sequence with the same effect on the tiles as 
+/// a shorter one, or an equally long one earlier in search order, which 
+/// moves the blank only over cells the duplicate visits too (so it is legal 
+/// wherever the duplicate is). The first optimal path in search order has 
+/// no duplicate in it, so the search still returns it.
+///
+/// The duplicates are found by enumerating move sequences of up to `length` 
+/// moves on an unbounded board; the automaton is the Aho-Corasick machine 
+/// of the shortest ones. With length 2 it only rejects undoing the last move.
+struct MovePruning {
+
+    static inline const int DEAD = -1;
+    static inline const int DEFAULT_LENGTH = 8;
+
+    explicit MovePruning(int length);
+
+    /// @param move index in Board::move_order
+    int next(int state, int move) const {
+        return transitions[state * 4 + move];
+    }
+
+    int states() const {
+        return transitions.size() / 4;
+    }
+
+    /// @brief the automaton that only rejects undoing the last move
+    static const MovePruning& reversals() {
+        static const MovePruning pruning(2);
+        return pruning;
+    }
+
+    std::size_t duplicates{0}; // sequences the automaton is built from
+
+private:
+    std::vector<int> transitions; // [state][move], 0 is the start state
+};
+
+
+MovePruning::MovePruning(int length) {
+    const int side = 2 * length + 1; // the blank never reaches the border
+    const int origin = length * side + length;
+
+    int offsets[4];
+    for(int m = 0; m < 4; ++m) {
+        const Move& d = Board::steps[m];
+        offsets[m] = d.x * side + d.y;
+    }
+
+    // sequences are packed 2 bits a move, the last move lowest
+    auto mask = [](int len) {
+        return (std::uint64_t(1) << (2 * len)) - 1;
+    };
+
+    // tiles are named after their start cell, the blank after the origin
+    auto zobrist = [](int id, int tile) {
+        std::uint64_t z = std::uint64_t(id) << 32 | std::uint32_t(tile);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return id == tile ? 0 : z ^ (z >> 31);
+    };
+
+    // the exact effect: cells visited by the blank, and the cells whose tile changed
+    auto effect = [&](std::uint64_t seq, int len, std::vector<int>& visited) {
+        std::map<int, int> holds;
+        int blank = origin;
+        visited.assign(1, origin);
+
+        for(int i = len - 1; i >= 0; --i) {
+            const int next = blank + offsets[seq >> (2 * i) & 3];
+            holds[blank] = holds.count(next) ? holds[next] : next;
+            holds[next] = origin;
+            blank = next;
+            visited.push_back(blank);
+        }
+
+        std::sort(visited.begin(), visited.end());
+        visited.erase(std::unique(visited.begin(), visited.end()), visited.end());
+
+        std::vector<std::pair<int, int>> changed;
+        for(const auto& id_tile: holds) {
+            if(id_tile.first != id_tile.second) {
+                changed.push_back(id_tile);
+            }
+        }
+        return changed;
+    };
+
+    std::unordered_map<std::uint64_t, std::pair<std::uint64_t, int>> keepers; // effect hash -> first sequence
+    std::vector<std::unordered_set<std::uint64_t>> forbidden(length + 1); // by length
+    std::vector<int> cells(side * side);
+    std::vector<int> visited;
+    std::vector<int> kept;
+
+    for(int i = 0; i < side * side; ++i) {
+        cells[i] = i;
+    }
+    keepers[0] = {0, 0}; // the empty sequence
+
+    // the sequence is a duplicate of the first one with its effect
+    auto duplicate = [&](std::uint64_t seq, int len, std::uint64_t hash) {
+        auto found = keepers.find(hash);
+        if(found == keepers.end()) {
+            keepers.emplace(hash, std::make_pair(seq, len));
+            return false;
+        }
+
+        // verify, hashes may collide
+        return effect(seq, len, visited) == effect(found->second.first, found->second.second, kept) &&
+               std::includes(visited.begin(), visited.end(), kept.begin(), kept.end());
+    };
+
+    // depth-first in search order, one length at a time, so that shorter 
+    // and earlier sequences are seen first
+    auto enumerate = [&](auto& self, std::uint64_t moves, int depth, int blank, 
+                         std::uint64_t hash, int len) -> void {
+        for(int m = 0; m < 4; ++m) {
+            const std::uint64_t seq = moves << 2 | m;
+            const int k = depth + 1;
+
+            bool pruned = false;
+            for(int j = 2; j <= k && not(pruned); ++j) {
+                pruned = forbidden[j].count(seq & mask(j));
+            }
+            if(pruned) {
+                continue;
+            }
+
+            const int next = blank + offsets[m];
+            std::uint64_t moved = hash ^ zobrist(blank, cells[blank]) ^ zobrist(next, cells[next]);
+            std::swap(cells[blank], cells[next]);
+            moved ^= zobrist(blank, cells[blank]) ^ zobrist(next, cells[next]);
+
+            if(k < len) {
+                self(self, seq, k, next, moved, len);
+            } else if(duplicate(seq, k, moved)) {
+                forbidden[k].insert(seq);
+            }
+
+            std::swap(cells[blank], cells[next]);
+        }
+    };
+
+    for(int len = 1; len <= length; ++len) {
+        enumerate(enumerate, 0, 0, origin, 0, len);
+    }
+
+    // the trie of the duplicates, then its failure links breadth-first
+    std::vector<std::array<int, 4>> children(1, {-1, -1, -1, -1});
+    std::vector<bool> dead(1, false);
+
+    for(int len = 2; len <= length; ++len) {
+        for(const std::uint64_t seq: forbidden[len]) {
+            int node{0};
+            for(int i = len - 1; i >= 0; --i) {
+                const int m = seq >> (2 * i) & 3;
+                if(children[node][m] < 0) {
+                    children[node][m] = children.size();
+                    children.push_back({-1, -1, -1, -1});
+                    dead.push_back(false);
+                }
+                node = children[node][m];
+            }
+            dead[node] = true;
+            ++duplicates;
+        }
+    }
+
+    transitions.assign(children.size() * 4, 0);
+    std::vector<int> fail(children.size(), 0);
+    std::vector<int> order{0};
+
+    for(std::size_t i = 0; i < order.size(); ++i) {
+        const int node = order[i];
+        dead[node] = dead[node] || dead[fail[node]];
+
+        for(int m = 0; m < 4; ++m) {
+            const int child = children[node][m];
+            if(child < 0) {
+                transitions[node * 4 + m] = node ? transitions[fail[node] * 4 + m] : 0;
+            } else {
+                fail[child] = node ? transitions[fail[node] * 4 + m] : 0;
+                transitions[node * 4 + m] = child;
+                order.push_back(child);
+            }
+        }
+    }
+
+    for(int& state: transitions) {
+        if(dead[state]) {
+            state = DEAD;
+        }
+    }
+}
+
+
+/// @brief Bounded transposition table of the least g a state was reached 
+/// with in the current IDA* iteration, keyed on PackedBoard::tiles. 
+/// Threads share it without locks: an entry holds its key xor-ed with its 
+/// data, so a torn write reads as a miss.
+struct TranspositionTable {
+
+    explicit TranspositionTable(std::size_t megabytes) {
+        std::size_t size{1};
+        while(size * 2 * sizeof(Entry) <= megabytes << 20) {
+            size *= 2;
+        }
+        entries.reset(new Entry[size]());
+        mask = size - 1;
+    }
+
+    void next_iteration() {
+        if(++generation == GENERATIONS) { // entries of old iterations would match again
+            for(std::size_t i = 0; i <= mask; ++i) {
+                entries[i].check = 0;
+                entries[i].data = 0;
+            }
+            generation = 1;
+        }
+    }
+
+    /// @brief records a visit of the state, unless this iteration already 
+    /// reached it with a smaller g, or with the same g in this or an 
+    /// earlier subtree (in depth-first order) - then the search below 
+    /// was or will be done there, and the visit can be pruned
+    /// @return whether to prune the visit, never for a g past MAX_G
+    bool visit(std::uint64_t key, int g, int subtree) {
+        if(g > MAX_G) { // would spill into the generation
+            return false;
+        }
+        Entry& e = entries[(key * 0x9E3779B97F4A7C15ull) >> 20 & mask];
+
+        const std::uint64_t data = e.data.load(std::memory_order_relaxed);
+        const std::uint64_t check = e.check.load(std::memory_order_relaxed);
+
+        if((check ^ data) == key && (data >> 8 & 0xFFFFFF) == generation) {
+            const int seen_g = data & 0xFF;
+            const int seen_subtree = data >> 32;
+            
+            if(seen_g < g || (seen_g == g && seen_subtree <= subtree)) {
+                return true;
+            }
+        }
+
+        const std::uint64_t updated = std::uint64_t(subtree) << 32 | 
+                                      std::uint64_t(generation) << 8 | g;
+        e.data.store(updated, std::memory_order_relaxed);
+        e.check.store(key ^ updated, std::memory_order_relaxed);
+        return false;
+    }
+
+private:
+
+    struct Entry {
+        std::atomic<std::uint64_t> check;
+        std::atomic<std::uint64_t> data; // subtree: 32 | generation: 24 | g: 8
+    };
+
+    static inline const std::uint32_t GENERATIONS = 1 << 24;
+    static inline const int MAX_G = 0xFF;
+
+    std::unique_ptr<Entry[]> entries;
+    std::size_t mask{0};
+    std::uint32_t generation{1};
+};
+
+
+/// @brief calls job(i, worker) for every i in [0, jobs) on `threads` threads. 
+/// Each worker owns a contiguous block of jobs and takes them lowest first; 
+/// an idle worker steals the highest job left in another worker's block.
+template<typename F>
+void work_stealing_for(int jobs, int threads, F job) {
+    struct Queue {
+        std::mutex m;
+        std::deque<int> jobs;
+    };
+
+    std::vector<Queue> queues(threads);
+    for(int w = 0; w < threads; ++w) {
+        for(int i = jobs * w / threads; i < jobs * (w + 1) / threads; ++i) {
+            queues[w].jobs.push_back(i);
+        }
+    }
+
+    auto take = [&queues, threads](int w, int& i) {
+        for(int k = 0; k < threads; ++k) {
+            Queue& q = queues[(w + k) % threads];
+            std::lock_guard<std::mutex> lock(q.m);
+
+            if(not(q.jobs.empty())) {
+                if(k == 0) { // own block
+                    i = q.jobs.front();
+                    q.jobs.pop_front();
+                } else {
+                    i = q.jobs.back();
+                    q.jobs.pop_back();
+                }
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<std::thread> workers;
+    for(int w = 0; w < threads; ++w) {
+        workers.emplace_back([&take, &job, w]() {
+            int i{42};
+            while(take(w, i)) {
+                job(i, w);
+            }
+        });
+    }
+
+    for(std::thread& worker: workers) {
+        worker.join();
+    }
+}
+
+
+/// @brief Cancels the searches it is passed to, from any thread
+struct CancellationToken {
+
+    void cancel() {
+        flag.store(true, std::memory_order_relaxed);
+    }
+
+    bool cancelled() const {
+        return flag.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<bool> flag{false};
+};
+
+
+/// @brief Search counters, kept per IDA* iteration. They are compiled in 
+/// with -DSTATS only, otherwise every update is discarded at compile time.
+struct SearchStats {
+
+#ifdef STATS
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    struct Counters {
+        std::uint64_t expanded{0}; // nodes whose children were generated
+        std::uint64_t generated{0}; // and evaluated, the heuristics are updated on every move
+
+        Counters& operator+=(const Counters& c) {
+            expanded += c.expanded;
+            generated += c.generated;
+            return *this;
+        }
+    };
+
+    struct Iteration {
+        int threshold;
+        Counters counters;
+        double seconds;
+    };
+
+    std::vector<Iteration> iterations;
+
+    /// @brief b such that a uniform tree of that branching factor and 
+    /// the given depth has `nodes` nodes: 1 + b + ... + b^depth = nodes
+    static double branching_factor(double nodes, int depth);
+
+    void write_json(std::ostream& os, int cost) const;
+};
+
+
+double SearchStats::branching_factor(double nodes, int depth) {
+    if(depth <= 0 || nodes <= depth + 1) {
+        return depth > 0 ? 1 : 0;
+    }
+
+    double low{1};
+    double high{nodes};
+
+    for(int step = 0; step < 100; ++step) {
+        const double b = (low + high) / 2;
+        double sum{1};
+        double power{1};
+
+        for(int i = 0; i < depth && sum <= nodes; ++i) {
+            power *= b;
+            sum += power;
+        }
+        (sum > nodes ? high : low) = b;
+    }
+    return low;
+}
+
+
+void SearchStats::write_json(std::ostream& os, int cost) const {
+    Counters total;
+    double seconds{0};
+
+    for(const Iteration& it: iterations) {
+        total += it.counters;
+        seconds += it.seconds;
+    }
+
+    auto counters = [&os](const Counters& c) {
+        os << "\"expanded\": " << c.expanded 
+           << ", \"generated\": " << c.generated;
+    };
+
+    os << "{\"cost\": " << cost << ", \"seconds\": " << seconds << ", ";
+    counters(total);
+    os << ", \"nodes_per_second\": " << (seconds > 0 ? total.generated / seconds : 0)
+       << ", \"branching_factor\": " << branching_factor(total.generated + 1, cost)
+       << ", \"iterations\": [";
+
+    for(std::size_t i = 0; i < iterations.size(); ++i) {
+        const Iteration& it = iterations[i];
+        os << (i ? ", " : "") << "{\"threshold\": " << it.threshold << ", ";
+        counters(it.counters);
+        os << ", \"seconds\": " << it.seconds 
+           << ", \"branching_factor\": " // children per expanded node
+           << (it.counters.expanded ? double(it.counters.generated) / it.counters.expanded : 0) 
+           << "}";
+    }
+    os << "]}";
+}
+
+
+/// @brief The states A* reached: packed boards in a vector reserved up 
+/// front, so it never moves, and an open-addressing hash table of their 
+/// indices keyed on the tiles, grown to stay at most half full.
+struct StateTable {
+
+    struct State {
+        std::uint64_t tiles;
+        std::uint16_t g; // the least cost it was reached at
+        std::uint8_t zero_id;
+        std::uint8_t move; // the last one on the way there, NO_MOVE at the root
+        std::uint16_t h{0}; // kept by the searches that need it again
+        bool open{false}; // likewise, whether it waits to be expanded at cost g
+    };
+
+    static inline const std::uint32_t EMPTY = UINT32_MAX;
+    static inline const std::uint8_t NO_MOVE = 4; // reversed, 5, is no move either
+
+    /// a state, its slots in a table at most half full and its entries in the open list
+    static inline const std::size_t BYTES_PER_STATE = sizeof(State) + 4 * sizeof(std::uint32_t) + 
+                                                      2 * sizeof(std::uint32_t);
+
+    explicit StateTable(std::size_t capacity): capacity(std::min<std::size_t>(capacity, EMPTY)) {
+        states.reserve(this->capacity);
+    }
+
+    /// @return the index of the state with the tiles, EMPTY if there is none
+    std::uint32_t find(std::uint64_t tiles) const {
+        return slots.empty() ? EMPTY : slots[probe(tiles)];
+    }
+
+    /// @brief adds a state that is not in the table, which is not full
+    std::uint32_t insert(const State& s) {
+        if(2 * (states.size() + 1) > slots.size()) {
+            grow();
+        }
+        slots[probe(s.tiles)] = states.size();
+        states.push_back(s);
+        return states.size() - 1;
+    }
+
+    bool full() const {
+        return states.size() >= capacity;
+    }
+
+    /// @brief starts loading the slot a find of the tiles probes first
+    void prefetch(std::uint64_t tiles) const {
+        if(not(slots.empty())) {
+            __builtin_prefetch(&slots[(tiles * 0x9E3779B97F4A7C15ull) >> 20 & mask]);
+        }
+    }
+
+    std::vector<State> states;
+
+private:
+
+    std::size_t probe(std::uint64_t tiles) const {
+        std::size_t i = (tiles * 0x9E3779B97F4A7C15ull) >> 20 & mask;
+        while(slots[i] != EMPTY && states[slots[i]].tiles != tiles) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void grow() {
+        slots.assign(std::max<std::size_t>(1024, 2 * slots.size()), EMPTY);
+        mask = slots.size() - 1;
+        for(std::size_t i = 0; i < states.size(); ++i) {
+            slots[probe(states[i].tiles)] = i;
+        }
+    }
+
+    std::size_t capacity;
+    std::vector<std::uint32_t> slots; // state indices, EMPTY if free
+    std::size_t mask{0};
+};
+
+
+/// @brief The open list of A*: a stack of state indices for every (f, g), 
+/// popped from the least f and within it the greatest g, the state 
+/// nearest the goal by its estimate. Both are bounded by the solution 
+/// length, so pushes and pops take amortized constant time.
+struct BucketQueue {
+
+    void push(int f, int g, std::uint32_t state) {
+        if(f >= int(buckets.size())) {
+            buckets.resize(f + 1);
+            top.resize(f + 1, -1);
+        }
+        if(g >= int(buckets[f].size())) {
+            buckets[f].resize(g + 1);
+        }
+
+        buckets[f][g].push_back(state);
+        least = std::min(least, f);
+        top[f] = std::max(top[f], g);
+        ++count;
+    }
+
+    /// @return false if the queue is empty
+    bool pop(std::uint32_t& state, int& f, int& g) {
+        f = least_key();
+        if(f == INT_MAX) {
+            return false;
+        }
+
+        g = top[f];
+        state = buckets[f][g].back();
+        buckets[f][g].pop_back();
+        --count;
+        return true;
+    }
+
+    /// @return the f of the next state popped, INT_MAX if there is none
+    int least_key() {
+        if(not(count)) {
+            return INT_MAX;
+        }
+
+        for(; ; ++least) {
+            for(; top[least] >= 0; --top[least]) {
+                if(not(buckets[least][top[least]].empty())) {
+                    return least;
+                }
+            }
+        }
+    }
+
+private:
+    std::vector<std::vector<std::vector<std::uint32_t>>> buckets; // by f, then g
+    std::vector<int> top; // by f, no g above it has a bucket with states
+    int least{INT_MAX}; // no f below it has
+    std::size_t count{0};
+};
+
+
+/// @brief The children of packed boards, but their parent, with their h: 
+/// the linear conflicts are counted a block at a time, the other 
+/// heuristics are updated from h of the parent.
+template<typename B, typename H>
+struct Successors {
+
+    Successors(const B& any, const H& heur):
+        boards{any, any, any, any},
+        eval(heur) {
+
+        if constexpr(std::is_same_v<H, LinearConflictEvaluator>) {
+            batch.emplace(heur.target);
+        }
+    }
+
+    /// @brief the first `count` boards, moves and hs become those of the children
+    /// @param h of the state
+    void generate(const StateTable::State& s, int h) {
+        B b = boards[0];
+        b.tiles = s.tiles;
+        b.zero_id = s.zero_id;
+
+        count = 0;
+        for(int m = 0; m < 4; ++m) {
+            boards[count] = b;
+            if(m != (s.move ^ 1) && boards[count].apply_move(m)) {
+                moves[count++] = m;
+            }
+        }
+
+        if constexpr(std::is_same_v<H, LinearConflictEvaluator>) {
+            batch->evaluate(boards.data(), count, hs);
+        } else {
+            eval.init(b);
+            for(int k = 0; k < count; ++k) {
+                const B& child = boards[k];
+                const int tile = child.at(b.zero_id);
+                hs[k] = eval.apply(child, h, tile, child.zero_id, b.zero_id);
+                eval.undo(tile, child.zero_id, b.zero_id);
+            }
+        }
+    }
+
+    std::array<B, 4> boards;
+    int moves[4];
+    int hs[4];
+    int count{0};
+
+private:
+    H eval;
+    std::optional<BatchEvaluator<B::size()>> batch;
+};
+
+
+struct Solution {
+
+    static inline const int FOUND = -1;
+    static inline const int FRONTIER_SIZE = 4000; // subtrees per parallel iteration
+    static inline const int HISTOGRAM_SIZE = 64; // f values past the threshold told apart
+    static inline const int POLL_INTERVAL = 4096; // nodes
+    static inline const int ANYTIME_WEIGHT = 300; // the first of an anytime search, unless given
+
+    Target& target;
+    Board b;
+
+    Heuristic heuristic{Heuristic::MANHATTAN};
+    const AdditivePdb* pdb{nullptr}; // required by Heuristic::PDB
+    const WalkingDistance* wd{nullptr}; // required by Heuristic::WALKING_DISTANCE
+
+    int threads{1}; // more than 1 for parallel IDA*
+
+    /// threshold prediction: the ratio of node counts aimed at between 
+    /// iterations, 0 to raise the threshold to the least f left out
+    double growth{0};
+    std::vector<std::uint64_t> pruned; // nodes left out in the iteration, by f - threshold - 1
+
+    int weight{100}; // percent of h in f, more for a solution at most weight / 100 times the optimal
+    double budget{0}; // anytime: seconds to improve the solution for, 0 for none
+    std::size_t astar_memory{0}; // bytes A* may take on packed boards before IDA* takes over, 0 for IDA* only
+    std::size_t bidirectional_memory{0}; // likewise for the bidirectional search, tried first
+
+    /// the search gives up past the deadline or once the token is cancelled, 
+    /// both are polled every POLL_INTERVAL nodes
+    std::chrono::steady_clock::time_point deadline{std::chrono::steady_clock::time_point::max()};
+    const CancellationToken* token{nullptr};
+    bool timed_out{false};
+    bool cancelled{false};
+    std::uint64_t nodes{0}; // searched within the thresholds
+    int iterations{0};
+    std::uint64_t visited{0}; // nodes within the threshold in the iteration
+    std::uint64_t previous{0}; // visited in the iteration before
+
+    const MovePruning* pruning{&MovePruning::reversals()};
+    int prune_state{0}; // of the pruning automaton, after path
+    TranspositionTable* tt{nullptr}; // optional, boards up to MAX_PACKED_DIM
+    const DistanceTable* table{nullptr}; // optional, answers 8-puzzles without a search
+
+    MoveStack path;
+    int sol_cost = INT_MAX;
+
+    SearchStats::Counters counters; // of the current iteration
+    SearchStats stats;
+
+    /// parallel IDA*: the lowest index of a subtree found to hold a solution,
+    /// the search of subtree `subtree` gives up once it is below it
+    const std::atomic<int>* first_found{nullptr};
+    int subtree{0};
+
+    /// @brief a node of the parallel IDA* frontier, searched as a task 
+    template<typename B, typename H>
+    struct Subtree {
+        B board;
+        H heur;
+        int g;
+        int h;
+        MoveStack path;
+        int prune_state;
+    };
+
+    /// @brief applies every move the pruning automaton allows after path, 
+    /// calls visit(child_h) and takes the move back.
+    /// Stops, leaving the move applied, as soon as visit returns true.
+    /// @return whether visit stopped the expansion
+    template<typename B, typename H, typename V>
+    bool expand(B& b, H& heur, int h, V visit) {
+        int from{42};
+        int tile{42};
+        const int state = prune_state;
+
+        for(int m = 0; m < 4; ++m) {
+            const int next = pruning->next(state, m);
+            if(next == MovePruning::DEAD) {
+                continue;
+            }
+
+            from = b.zero_id;
+            if(b.apply_move(m)) {
+                // only the tile that slid onto the old blank cell moved
+                tile = b.at(from);
+
+                if constexpr(SearchStats::ENABLED) {
+                    ++counters.generated;
+                }
+
+                path.push_back(m);
+                prune_state = next;
+                if(visit(heur.apply(b, h, tile, b.zero_id, from))) {
+                    return true;
+                }
+
+                prune_state = state;
+                heur.undo(tile, b.zero_id, from);
+                b.apply_move(m ^ 1);
+                path.pop_back();
+            }
+        }
+
+        return false;
+    }
+
+    /// @brief  performs depth-limited search
+    /// @param b the current node, a Board or one of a fixed size
+    /// @param heur the heuristic evaluator
+    /// @param g the cost function, level-wise
+    /// @param h the heuristic value of b, kept up to date by the caller
+    /// @param threshold determines the termination condition
+    /// @return  FOUND if the goal state is reached
+    template<typename B, typename H>
+    int search(B& b, H& heur, int g, int h, int threshold) {
+        int f = g + h;
+        if(f > threshold) {
+            if(growth) {
+                prune(f - threshold - 1);
+            }
+            return f;
+        }
+
+        if(growth) {
+            ++visited;
+        }
+
+        if(h == 0) { // Goal state reached
+            sol_cost = g;
+            return FOUND;
+        }
+
+        if(first_found && first_found->load(std::memory_order_relaxed) < subtree) {
+            return INT_MAX; // an earlier subtree holds the solution
+        }
+
+        if(interrupted()) {
+            return INT_MAX;
+        }
+
+        if constexpr(B::PACKED) {
+            if(tt && tt->visit(b.tiles, g, subtree)) {
+                return INT_MAX;
+            }
+        }
+
+
+        if constexpr(SearchStats::ENABLED) {
+            ++counters.expanded;
+        }
+
+        int min = INT_MAX;
+        int temp{42};
+
+        const bool found = expand(b, heur, h, [&](int child_h) {
+            temp = search(b, heur, g + 1, child_h, threshold);
+
+            if(temp == FOUND) {
+                return true;
+            } 
+            if(temp < min) {
+                min = temp;
+            }
+            return false;
+        });
+
+        return found ? FOUND : min;
+    }
+
+    /// @brief collects the nodes `depth` levels below b, in depth-first order,
+    /// that are within the threshold; goal nodes above that depth too
+    /// @return  the least f that exceeded the threshold
+    template<typename B, typename H>
+    int split(B& b, H& heur, int g, int h, int threshold, int depth,
+              std::vector<Subtree<B, H>>& frontier) {
+        int f = g + h;
+        if(f > threshold) {
+            if(growth) {
+                prune(f - threshold - 1);
+            }
+            return f;
+        }
+
+        if(h == 0 || depth == 0) {
+            frontier.push_back(Subtree<B, H>{b, heur, g, h, path, prune_state});
+            return INT_MAX;
+        }
+
+        if constexpr(SearchStats::ENABLED) {
+            ++counters.expanded;
+        }
+
+        int min = INT_MAX;
+
+        expand(b, heur, h, [&](int child_h) {
+            min = std::min(min, split(b, heur, g + 1, child_h, threshold, depth - 1, frontier));
+            return false;
+        });
+
+        return min;
+    }
+
+    /// @brief looks the solution up in the distance table if there is 
+    /// one, searches for it otherwise
+    void solve() {
+        if(table) {
+            lookup();
+        } else {
+            idastar();
+        }
+    }
+
+    /// @brief follows decreasing distances down to the goal, taking the 
+    /// first such move in move order, so the path is the one IDA* returns
+    void lookup() {
+        PackedBoard<DistanceTable::DIM> board(b);
+        sol_cost = table->distance(board);
+        path.clear();
+
+        for(int d = sol_cost; d > 0; --d) {
+            for(int m = 0; m < 4; ++m) {
+                if(board.apply_move(m)) {
+                    if(table->distance(board) == d - 1) {
+                        path.push_back(m);
+                        break;
+                    }
+                    board.apply_move(m ^ 1);
+                }
+            }
+        }
+    }
+
+    /// @brief searches on a board type of the size read, so that its 
+    /// move table and cell arithmetic are compile-time constants
+    void idastar() {
+        if(tt && b.size() > MAX_PACKED_DIM) {
+            throw std::runtime_error("The transposition table needs boards up to 4x4!");
+        }
+
+        switch(b.size()) {
+            case 2: {
+                PackedBoard<2> root(b);
+                idastar(root);
+                break;
+            }
+            case 3: {
+                PackedBoard<3> root(b);
+                idastar(root);
+                break;
+            }
+            case 4: {
+                PackedBoard<4> root(b);
+                idastar(root);
+                break;
+            }
+            case 5: {
+                ArrayBoard<5> root(b);
+                idastar(root);
+                break;
+            }
+            case 6: {
+                ArrayBoard<6> root(b);
+                idastar(root);
+                break;
+            }
+            default: {
+                idastar(b);
+            }
+        }
+    }
+
+    template<typename B>
+    void idastar(B& root) {
+        switch(heuristic) {
+            case Heuristic::PDB: {
+                assert(pdb);
+                PdbEvaluator heur(*pdb, target);
+                run(root, heur);
+                break;
+            }
+            case Heuristic::LINEAR_CONFLICT: {
+                LinearConflictEvaluator heur(target);
+                run(root, heur);
+                break;
+            }
+            case Heuristic::WALKING_DISTANCE: {
+                assert(wd);
+                WalkingDistanceEvaluator heur(*wd, target);
+                run(root, heur);
+                break;
+            }
+            default: {
+                ManhattanEvaluator heur{target};
+                run(root, heur);
+            }
+        }
+    }
+
+    template<typename B, typename H>
+    void run(B& root, H& heur) {
+        if(weight == 100 && budget <= 0) {
+            if constexpr(B::PACKED) {
+                if(bidirectional_memory && bidirectional(root, heur)) {
+                    return;
+                }
+                if(astar_memory && astar(root, heur)) {
+                    return;
+                }
+            }
+            idastar(root, heur);
+        } else {
+            weighted_idastar(root, heur);
+        }
+    }
+
+    /// @brief A*, which expands every state once rather than once per 
+    /// iteration, for the instances whose states fit in astar_memory. 
+    /// A state reached again more cheaply is pushed again, so it stays 
+    /// optimal with the heuristics that are not consistent. Among the 
+    /// states of the least f the deepest is expanded first, its children 
+    /// in move order, so the path is often, not always, the one IDA* 
+    /// returns: another one of the same length.
+    /// @return false if the states did not fit, IDA* has to search
+    template<typename B, typename H>
+    bool astar(const B& root, const H& heur) {
+        using State = StateTable::State;
+
+        const auto start = std::chrono::steady_clock::now();
+        StateTable table(astar_memory / StateTable::BYTES_PER_STATE);
+        BucketQueue open;
+        H eval = heur;
+        Successors<B, H> next(root, heur);
+
+        const int h = eval.init(root);
+        open.push(h, 0, table.insert({root.tiles, 0, std::uint8_t(root.zero_id), StateTable::NO_MOVE}));
+
+        std::uint32_t i{0};
+        int f{0};
+        int g{0};
+        int cost{INT_MAX};
+
+        while(open.pop(i, f, g)) {
+            const State s = table.states[i];
+            if(s.g != g) { // reached more cheaply since it was pushed
+                continue;
+            }
+            if(f == g) { // h is 0, the goal
+                cost = g;
+                break;
+            }
+            if(interrupted()) {
+                break;
+            }
+
+            if constexpr(SearchStats::ENABLED) {
+                ++counters.expanded;
+            }
+
+            next.generate(s, f - g);
+            for(int k = 0; k < next.count; ++k) {
+                table.prefetch(next.boards[k].tiles);
+            }
+
+            if constexpr(SearchStats::ENABLED) {
+                counters.generated += next.count;
+            }
+
+            for(int k = next.count - 1; k >= 0; --k) { // the first move is popped first
+                const B& child = next.boards[k];
+                const std::uint32_t j = table.find(child.tiles);
+
+                if(j == StateTable::EMPTY) {
+                    if(table.full()) {
+                        record(f, start);
+                        return false;
+                    }
+                    open.push(g + 1 + next.hs[k], g + 1,
+                              table.insert({child.tiles, std::uint16_t(g + 1), std::uint8_t(child.zero_id), 
+                                            std::uint8_t(next.moves[k])}));
+                } else if(g + 1 < table.states[j].g) {
+                    table.states[j].g = g + 1;
+                    table.states[j].move = next.moves[k];
+                    open.push(g + 1 + next.hs[k], g + 1, j);
+                }
+            }
+        }
+
+        if(cost >= MAX_SOLUTION_LENGTH && cost != INT_MAX) {
+            throw std::runtime_error("Paths of more than " + std::to_string(MAX_SOLUTION_LENGTH) + 
+                                     " moves are not searched!");
+        }
+
+        if(cost != INT_MAX) {
+            const MoveStack back = trace(table, i, root);
+            path.clear();
+            for(int k = back.size() - 1; k >= 0; --k) {
+                path.push_back(back[k]);
+            }
+            sol_cost = cost;
+        }
+
+        record(cost, start);
+        ++iterations;
+        return true;
+    }
+
+    /// @brief the moves from the root of the table to state i, the last first: 
+    /// every state was last reached from its parent by its move
+    template<typename B>
+    static MoveStack trace(const StateTable& table, std::uint32_t i, B b) {
+        MoveStack back;
+        for(StateTable::State s = table.states[i]; s.move != StateTable::NO_MOVE; ) {
+            back.push_back(s.move);
+            b.tiles = s.tiles;
+            b.zero_id = s.zero_id;
+            b.apply_move(s.move ^ 1);
+            s = table.states[table.find(b.tiles)];
+        }
+        return back;
+    }
+
+    /// @brief the open states of one direction of the bidirectional search
+    /// and the least f and g among them
+    struct Frontier {
+
+        explicit Frontier(std::size_t capacity): table(capacity) {
+        }
+
+        void open(std::uint32_t i, int g, int h) {
+            StateTable::State& s = table.states[i];
+            s.g = g;
+            s.h = h;
+            s.open = true;
+            queue.push(std::max(g + h, 2 * g), g, i);
+            add(by_f, least_f, g + h);
+            add(by_g, least_g, g);
+        }
+
+        void close(std::uint32_t i) {
+            StateTable::State& s = table.states[i];
+            s.open = false;
+            --by_f[s.g + s.h];
+            --by_g[s.g];
+        }
+
+        int min_f() {
+            return least(by_f, least_f);
+        }
+
+        int min_g() {
+            return least(by_g, least_g);
+        }
+
+        StateTable table;
+        BucketQueue queue; // by the priority max(f, 2g), then g
+
+    private:
+
+        static void add(std::vector<std::size_t>& counts, int& least, int value) {
+            if(value >= int(counts.size())) {
+                counts.resize(value + 1, 0);
+            }
+            ++counts[value];
+            least = std::min(least, value);
+        }
+
+        static int least(const std::vector<std::size_t>& counts, int& least) {
+            while(least < int(counts.size()) && not(counts[least])) {
+                ++least;
+            }
+            return least < int(counts.size()) ? least : INT_MAX;
+        }
+
+        std::vector<std::size_t> by_f; // open states by f
+        std::vector<std::size_t> by_g;
+        int least_f{INT_MAX}; // no open state has a smaller f
+        int least_g{INT_MAX};
+    };
+
+    /// @brief the bidirectional search, with an evaluator of the same 
+    /// heuristic towards the start for the backward direction. The walking 
+    /// distance needs tables of its own for it, the pattern databases are 
+    /// only built for the goal, so h=pdb is left to IDA*.
+    /// @return false if it did not run or the states did not fit, IDA* has to search
+    template<typename B, typename H>
+    bool bidirectional(const B& root, const H& heur) {
+        const Board& start_board = b;
+        const Target start = Target::of(start_board);
+
+        if constexpr(std::is_same_v<H, ManhattanEvaluator>) {
+            return meet_in_the_middle(root, heur, ManhattanEvaluator{start});
+        } else if constexpr(std::is_same_v<H, LinearConflictEvaluator>) {
+            return meet_in_the_middle(root, heur, LinearConflictEvaluator(start));
+        } else if constexpr(std::is_same_v<H, WalkingDistanceEvaluator>) {
+            const WalkingDistance tables(start);
+            return meet_in_the_middle(root, heur, WalkingDistanceEvaluator(tables, start));
+        } else {
+            return false;
+        }
+    }
+
+    /// @brief MM: A* from the root to the goal and from the goal, the one 
+    /// of Target::init_target, back to the root, each expanding the state 
+    /// of the least priority max(f, 2g) first, deepest first among equal 
+    /// ones, from the direction whose least priority is smaller. The two 
+    /// meet in the middle of the optimal path, neither searches far past 
+    /// it. Every state generated is looked up in the other direction, the 
+    /// cheapest path through one found so far costs U; no path costs less 
+    /// than any of the least priority, the least f of either direction, 
+    /// and the least g of both plus a move, so U is optimal once it is at 
+    /// most their maximum.
+    /// @return false if the states did not fit, IDA* has to search
+    template<typename B, typename HF, typename HB>
+    bool meet_in_the_middle(const B& root, const HF& forward_heur, const HB& backward_heur) {
+        const auto start = std::chrono::steady_clock::now();
+
+        B goal = root;
+        goal.tiles = 0;
+        for(int tile = 1; tile < B::CELLS; ++tile) {
+            goal.tiles |= std::uint64_t(tile) << (4 * target.goal(tile));
+        }
+        goal.zero_id = target.goal(0);
+
+        const std::size_t capacity = bidirectional_memory / 2 / StateTable::BYTES_PER_STATE;
+        Frontier forward(capacity);
+        Frontier backward(capacity);
+        Successors<B, HF> forward_next(root, forward_heur);
+        Successors<B, HB> backward_next(root, backward_heur);
+
+        forward.open(forward.table.insert({root.tiles, 0, std::uint8_t(root.zero_id), StateTable::NO_MOVE}),
+                     0, HF(forward_heur).init(root));
+        backward.open(backward.table.insert({goal.tiles, 0, std::uint8_t(goal.zero_id), StateTable::NO_MOVE}),
+                      0, HB(backward_heur).init(goal));
+
+        int cost = root.tiles == goal.tiles ? 0 : INT_MAX; // U
+        std::uint64_t meeting = root.tiles;
+
+        while(true) {
+            const int least_forward = forward.queue.least_key();
+            const int least_backward = backward.queue.least_key();
+            if(least_forward == INT_MAX || least_backward == INT_MAX) {
+                break;
+            }
+
+            const int bound = std::max({std::min(least_forward, least_backward), 
+                                        forward.min_f(), backward.min_f(),
+                                        forward.min_g() + backward.min_g() + 1});
+            if(cost <= bound || interrupted()) {
+                break;
+            }
+
+            const bool ahead = least_forward <= least_backward;
+            Frontier& from = ahead ? forward : backward;
+            Frontier& other = ahead ? backward : forward;
+
+            std::uint32_t i{0};
+            int priority{0};
+            int g{0};
+            from.queue.pop(i, priority, g);
+            const StateTable::State s = from.table.states[i];
+            if(not(s.open) || s.g != g) { // expanded or reached more cheaply since it was pushed
+                continue;
+            }
+            from.close(i);
+
+            if constexpr(SearchStats::ENABLED) {
+                ++counters.expanded;
+            }
+
+            const int count = ahead ? (forward_next.generate(s, s.h), forward_next.count)
+                                    : (backward_next.generate(s, s.h), backward_next.count);
+            const std::array<B, 4>& boards = ahead ? forward_next.boards : backward_next.boards;
+            const int* moves = ahead ? forward_next.moves : backward_next.moves;
+            const int* hs = ahead ? forward_next.hs : backward_next.hs;
+
+            if constexpr(SearchStats::ENABLED) {
+                counters.generated += count;
+            }
+
+            for(int k = count - 1; k >= 0; --k) {
+                const B& child = boards[k];
+                std::uint32_t j = from.table.find(child.tiles);
+
+                if(j == StateTable::EMPTY) {
+                    if(from.table.full()) {
+                        record(bound, start);
+                        return false;
+                    }
+                    j = from.table.insert({child.tiles, std::uint16_t(g + 1), std::uint8_t(child.zero_id), 
+                                           std::uint8_t(moves[k])});
+                } else if(g + 1 < from.table.states[j].g) {
+                    if(from.table.states[j].open) {
+                        from.close(j);
+                    }
+                    from.table.states[j].move = moves[k];
+                } else {
+                    continue;
+                }
+                from.open(j, g + 1, hs[k]);
+
+                const std::uint32_t met = other.table.find(child.tiles);
+                if(met != StateTable::EMPTY && g + 1 + other.table.states[met].g < cost) {
+                    cost = g + 1 + other.table.states[met].g;
+                    meeting = child.tiles;
+                }
+            }
+        }
+
+        if(cost >= MAX_SOLUTION_LENGTH && cost != INT_MAX) {
+            throw std::runtime_error("Paths of more than " + std::to_string(MAX_SOLUTION_LENGTH) + 
+                                     " moves are not searched!");
+        }
+
+        if(cost != INT_MAX && not(stopped())) {
+            // to the meeting state, then from it back along the moves of the backward search
+            const MoveStack there = trace(forward.table, forward.table.find(meeting), root);
+            const MoveStack back = trace(backward.table, backward.table.find(meeting), root);
+
+            path.clear();
+            for(int k = there.size() - 1; k >= 0; --k) {
+                path.push_back(there[k]);
+            }
+            for(int k = 0; k < back.size(); ++k) {
+                path.push_back(back[k] ^ 1);
+            }
+            sol_cost = cost;
+        }
+
+        record(cost, start);
+        ++iterations;
+        return true;
+    }
+
+    /// @brief weighted IDA*. Given a budget, anytime: weighted IDA* runs 
+    /// for solutions cheaper than the best so far, halving the excess of 
+    /// the weight over 1 every time, until a run with weight 1 proves the 
+    /// best optimal or the deadline passes.
+    template<typename B, typename H>
+    void weighted_idastar(B& root, H& heur) {
+        if(budget <= 0) {
+            WeightedEvaluator<H> eval(heur, weight);
+            idastar(root, eval);
+            return;
+        }
+
+        deadline = std::min(deadline, std::chrono::steady_clock::now() + 
+                                      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                            std::chrono::duration<double>(budget)));
+
+        const int root_state = prune_state;
+        MoveStack best;
+        int best_cost{INT_MAX};
+
+        for(int w = weight != 100 ? weight : ANYTIME_WEIGHT; ; w = 100 + (w - 100) / 2) {
+            WeightedEvaluator<H> eval(heur, w, best_cost);
+            path.clear();
+            prune_state = root_state;
+            sol_cost = INT_MAX;
+
+            idastar(root, eval);
+            if(sol_cost < best_cost) {
+                best = path;
+                best_cost = sol_cost;
+            }
+            if(stopped() || w == 100) {
+                break;
+            }
+        }
+
+        path = best; // empty and INT_MAX if none was found in time
+        sol_cost = best_cost;
+    }
+
+    /// @brief counts a node, polls the deadline and the token every POLL_INTERVAL nodes
+    bool interrupted() {
+        if(++nodes % POLL_INTERVAL == 0) {
+            timed_out = timed_out || std::chrono::steady_clock::now() > deadline;
+            cancelled = cancelled || (token && token->cancelled());
+        }
+        return stopped();
+    }
+
+    bool stopped() const {
+        return timed_out || cancelled;
+    }
+
+    /// @brief IDA*. With threshold prediction, a threshold past the least 
+    /// f left out may skip the optimal cost: a solution found then is only 
+    /// kept once plain iterations bounded below its cost find none cheaper.
+    /// Stopped early, the solution is that one if any, none otherwise.
+    template<typename B, typename H>
+    void idastar(B& root, H& heur) {
+        const int h = heur.init(root);
+        const int root_state = prune_state;
+        int threshold = h; // the heuristic value of root
+        int least = h; // no solution costs less
+        int temp{42};
+
+        MoveStack best; // a solution that may not be optimal
+        int best_cost{INT_MAX};
+
+        while(not(stopped())) {
+            if(threshold >= BEYOND_BOUND) { // the root is, no solution within the bound
+                break;
+            }
+            if(threshold >= MAX_SOLUTION_LENGTH) { // g <= f <= threshold on the path
+                throw std::runtime_error("Paths of more than " + std::to_string(MAX_SOLUTION_LENGTH) + 
+                                         " moves are not searched!");
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            if(tt) {
+                tt->next_iteration();
+            }
+            if(growth) {
+                pruned.assign(HISTOGRAM_SIZE, 0);
+                previous = visited;
+                visited = 0;
+            }
+
+            temp = threads > 1 ? parallel_iteration(root, heur, h, threshold) 
+                               : iteration(root, heur, h, threshold);
+            record(threshold, start);
+            ++iterations;
+
+            if(temp == FOUND) {
+                if(sol_cost <= least || weight != 100 || budget > 0) { // optimal or need not be
+                    break;
+                }
+                // the threshold may have skipped the optimal cost, go on 
+                // with plain IDA* from the least f left out up to this cost
+                best = path;
+                best_cost = sol_cost;
+                sol_cost = INT_MAX;
+                path.clear();
+                prune_state = root_state;
+                threshold = least;
+                continue;
+            }
+
+            if(stopped() || temp >= BEYOND_BOUND) { // cut short, or no solution within the bound
+                break;
+            }
+
+            least = temp;
+            if(least >= best_cost) { // none cheaper than the best
+                path = best;
+                sol_cost = best_cost;
+                break;
+            }
+
+            threshold = growth && best_cost == INT_MAX ? predict(threshold, temp) : temp;
+        }
+
+        if(sol_cost == INT_MAX && best_cost != INT_MAX) { // stopped before proving it optimal
+            path = best;
+            sol_cost = best_cost;
+        }
+    }
+
+    /// @brief an iteration searching a copy of the root, 
+    /// a solution found is left applied to it
+    template<typename B, typename H>
+    int iteration(const B& root, const H& heur, int h, int threshold) {
+        B b = root;
+        H eval = heur;
+        return search(b, eval, 0, h, threshold);
+    }
+
+    /// @brief an iteration that splits the tree into a frontier of subtrees 
+    /// searched by a work-stealing pool. The solution kept is the one of 
+    /// the first subtree in depth-first order, the same the sequential 
+    /// search returns; later subtrees are cut off once it is found.
+    template<typename B, typename H>
+    int parallel_iteration(B& root, H& heur, int h, int threshold) {
+        std::vector<Subtree<B, H>> frontier;
+        int min{INT_MAX};
+
+        // deepen the split until the frontier is large enough to balance
+        for(int depth = 1; ; ++depth) {
+            std::vector<Subtree<B, H>> deeper;
+            if(growth) { // only the last split counts
+                pruned.assign(HISTOGRAM_SIZE, 0);
+            }
+            min = split(root, heur, 0, h, threshold, depth, deeper);
+
+            const bool grew = deeper.size() > frontier.size();
+            frontier.swap(deeper);
+            if(not(grew) || frontier.size() >= FRONTIER_SIZE) {
+                break;
+            }
+        }
+
+        std::atomic<int> first{INT_MAX};
+        std::vector<int> results(frontier.size(), INT_MAX);
+        std::vector<Solution> workers(threads, *this);
+        for(Solution& worker: workers) {
+            worker.counters = {};
+            worker.pruned.assign(pruned.size(), 0);
+            worker.visited = 0;
+            worker.nodes = 0;
+        }
+
+        work_stealing_for(frontier.size(), threads, [&](int i, int w) {
+            if(first.load() < i) {
+                return;
+            }
+
+            Solution& worker = workers[w];
+            Subtree<B, H>& node = frontier[i];
+            
+            worker.path = node.path;
+            worker.prune_state = node.prune_state;
+            worker.first_found = &first;
+            worker.subtree = i;
+            results[i] = worker.search(node.board, node.heur, node.g, node.h, threshold);
+
+            if(results[i] == FOUND) {
+                node.path = worker.path;
+                int current = first.load();
+                while(i < current && not(first.compare_exchange_weak(current, i)));
+            }
+        });
+
+        for(const Solution& worker: workers) {
+            counters += worker.counters;
+            for(std::size_t i = 0; i < pruned.size(); ++i) {
+                pruned[i] += worker.pruned[i];
+            }
+            visited += worker.visited;
+            nodes += worker.nodes;
+            timed_out = timed_out || worker.timed_out;
+            cancelled = cancelled || worker.cancelled;
+        }
+
+        if(first.load() != INT_MAX) {
+            path = frontier[first.load()].path;
+            sol_cost = path.size();
+            return FOUND;
+        }
+
+        for(int result: results) {
+            min = std::min(min, result);
+        }
+        return min;
+    }
+
+    /// @brief threshold prediction: the least threshold from `least` on that 
+    /// lets in enough of the nodes the last iteration left out for the next 
+    /// one to visit about `growth` times as many nodes
+    int predict(int threshold, int least) const {
+        const double wanted = (growth - 1) * visited;
+        double admitted{0};
+        int last{least}; // all of them in
+
+        for(int i = 0; i < int(pruned.size()); ++i) {
+            if(pruned[i]) {
+                admitted += pruned[i];
+                last = threshold + 1 + i;
+                if(admitted >= wanted) {
+                    return last;
+                }
+            }
+        }
+
+        // with unit costs the nodes left out lie a step or two past the threshold,
+        // farther thresholds multiply them by the growth of the last iteration
+        const double measured = previous ? double(visited) / previous : 0;
+        const int step = least - threshold;
+        while(measured > 1 && admitted < wanted && last + step < threshold + HISTOGRAM_SIZE) {
+            admitted *= measured;
+            last += step;
+        }
+        return last;
+    }
+
+    /// @brief counts a node left out for f = threshold + 1 + excess
+    void prune(int excess) {
+        ++pruned[std::min(excess, int(pruned.size()) - 1)];
+    }
+
+
+
+    /// @brief closes the counters of an iteration
+    void record(int threshold, std::chrono::steady_clock::time_point start) {
+        if constexpr(SearchStats::ENABLED) {
+            const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+            stats.iterations.push_back({threshold, counters, seconds.count()});
+            counters = {};
+        }
+    }
+
+    Solution(Target& t): target(t), 
+                         b(std::sqrt(t.size()),
+                           t.posistions) {
+    } 
+
+    friend std::istream& operator>>(std::istream& is,
+                                    Solution& s) {
+        is >> s.b.tiles;
+        s.b.blank_coordinates();
+        
+        if(not(s.b.solvable())) {
+            throw(std::runtime_error("-1")); // text modified to adhere to output requirements
+        }
+
+        return is;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, 
+                                    Solution& s) {
+
+        if(s.sol_cost == INT_MAX) { // stopped before any was found
+            return os << "No solution found within the time budget!\n" << std::endl;
+        }
+
+        os << s.sol_cost << '\n';
+    
+        return os << s.path;
+    }
+
+
+};
+
+
+
+struct ArgParser {
+
+    ArgParser(char** args) {
+        while(*(++args)) {
+            const std::string arg(*args);
+
+            if(arg == "t") {
+                time = true;
+            } else if(arg == "h=manhattan") {
+                heuristic = Heuristic::MANHATTAN;
+            } else if(arg == "h=pdb") {
+                heuristic = Heuristic::PDB;
+            } else if(arg == "h=lc") {
+                heuristic = Heuristic::LINEAR_CONFLICT;
+            } else if(arg == "h=wd") {
+                heuristic = Heuristic::WALKING_DISTANCE;
+            } else if(arg.rfind("pdb=", 0) == 0) {
+                heuristic = Heuristic::PDB;
+                partition = arg.substr(4);
+            } else if(arg.rfind("threads=", 0) == 0) {
+                threads = std::stoi(arg.substr(8));
+                if(threads <= 0) {
+                    threads = std::max(1u, std::thread::hardware_concurrency());
+                }
+            } else if(arg.rfind("grow=", 0) == 0) {
+                growth = std::stod(arg.substr(5));
+                if(growth <= 1) {
+                    throw std::runtime_error("The growth ratio must be more than 1!");
+                }
+            } else if(arg.rfind("w=", 0) == 0) {
+                weight = std::lround(100 * std::stod(arg.substr(2)));
+                if(weight < 100) {
+                    throw std::runtime_error("The weight must be at least 1!");
+                }
+            } else if(arg.rfind("astar=", 0) == 0) {
+                astar_memory = std::stoull(arg.substr(6)) << 20;
+            } else if(arg.rfind("bidir=", 0) == 0) {
+                bidirectional_memory = std::stoull(arg.substr(6)) << 20;
+            } else if(arg.rfind("budget=", 0) == 0) {
+                budget = std::stod(arg.substr(7));
+            } else if(arg.rfind("prune=", 0) == 0) {
+                prune_length = std::stoi(arg.substr(6));
+            } else if(arg.rfind("tt=", 0) == 0) {
+                tt_megabytes = std::stoi(arg.substr(3));
+            } else if(arg == "stats") {
+                stats = true;
+            } else if(arg == "table") {
+                table = true;
+            } else if(arg == "batch") {
+                batch = true;
+            } else if(arg.rfind("pdbfile=", 0) == 0) {
+                heuristic = Heuristic::PDB;
+                pdb_file = arg.substr(8);
+            } else if(arg.rfind("pdbmem=", 0) == 0) {
+                pdb_memory = std::stoull(arg.substr(7)) << 20;
+            } else if(arg.rfind("pdbtmp=", 0) == 0) {
+                pdb_dir = arg.substr(7);
+            } else {
+
+                std::cout << *args << std::endl;
+                throw std::runtime_error(usage);
+
+            }
+        } 
+    }
+
+    
+    bool time{false};
+    Heuristic heuristic{Heuristic::MANHATTAN};
+    std::string partition; // empty for the default one of the board size
+    std::string pdb_file; // where the pattern database is mapped from / saved to
+    std::size_t pdb_memory{0}; // bytes to build it in on disk, 0 to build it in memory
+    std::string pdb_dir; // of its files while built on disk, the temporary directory if empty
+    int threads{1}; // 0 for all cores
+    bool batch{false}; // many puzzles, solved by `threads` threads
+    bool table{false}; // 8-puzzles answered from a distance table
+    bool stats{false}; // search counters as JSON on stderr, needs -DSTATS
+    int prune_length{MovePruning::DEFAULT_LENGTH}; // of the duplicate move sequences pruned
+    double growth{0}; // of the node counts between iterations, 0 for plain IDA*
+    int weight{100}; // percent of h in f
+    double budget{0}; // seconds for the anytime search, 0 for none
+    std::size_t astar_memory{0}; // bytes for A* before falling back to IDA*, 0 for IDA* only
+    std::size_t bidirectional_memory{0}; // likewise for the bidirectional search
+    int tt_megabytes{0}; // size of the transposition table, 0 for none
+
+    static inline const std::string usage{"Usage: <program name> <optional: t> "
+                                          "<optional: h=manhattan|h=pdb|h=lc|h=wd> "
+                                          "<optional: pdb=<partition, e.g. 6-6-3>> "
+                                          "<optional: pdbfile=<path>> "
+                                          "<optional: pdbmem=<MB to build the pdb on disk in>> "
+                                          "<optional: pdbtmp=<directory of its files>> "
+                                          "<optional: threads=<n, 0 for all cores>> "
+                                          "<optional: batch> "
+                                          "<optional: table> "
+                                          "<optional: stats> "
+                                          "<optional: grow=<node count ratio between iterations>> "
+                                          "<optional: w=<suboptimality bound, at least 1>> "
+                                          "<optional: budget=<seconds for the anytime search>> "
+                                          "<optional: astar=<MB for A* before IDA*>> "
+                                          "<optional: bidir=<MB for the bidirectional search before IDA*>> "
+                                          "<optional: prune=<duplicate sequence length, min 2>> "
+                                          "<optional: tt=<transposition table MB>>"};
+};
+
+
+/// @brief A target with the heuristic tables built for it, 
+/// shared read-only by all the solutions heading for it
+struct Goal {
+
+    Goal(const Target& t, const ArgParser& ap): target(t) {
+        if(ap.heuristic == Heuristic::PDB) {
+            const ExternalPdbBuild external{ap.pdb_dir.empty() ? 
+                                                std::filesystem::temp_directory_path().string() : 
+                                                ap.pdb_dir,
+                                            ap.pdb_memory,
+                                            ap.threads};
+            pdb = AdditivePdb::open(target, ap.partition, ap.pdb_file, 
+                                    ap.pdb_memory ? &external : nullptr);
+        }
+        if(ap.heuristic == Heuristic::WALKING_DISTANCE) {
+            wd = std::make_unique<WalkingDistance>(target);
+        }
+        if(ap.table && target.size() == DistanceTable::CELLS) {
+            table = std::make_unique<DistanceTable>(target);
+        }
+    }
+
+    void configure(Solution& s, const ArgParser& ap) const {
+        s.heuristic = ap.heuristic;
+        s.pdb = pdb.get();
+        s.wd = wd.get();
+        s.table = table.get();
+        s.growth = ap.growth;
+        s.weight = ap.weight;
+        s.budget = ap.budget;
+        s.astar_memory = ap.astar_memory;
+        s.bidirectional_memory = ap.bidirectional_memory;
+    }
+
+    Target target;
+    std::unique_ptr<AdditivePdb> pdb;
+    std::unique_ptr<WalkingDistance> wd;
+    std::unique_ptr<DistanceTable> table;
+};
+
+
+/// @brief The outcome of Solver::solve
+struct SolveResult {
+
+    enum class Status {
+        SOLVED, // optimal, or within the weight given
+        UNSOLVABLE,
+        TIMED_OUT, // the solution, if any, is the best found in time
+        CANCELLED,
+    };
+
+    Status status{Status::SOLVED};
+    int cost{-1}; // of the solution, -1 if there is none
+    std::vector<std::string> moves;
+
+    std::uint64_t nodes{0}; // searched within the thresholds
+    int iterations{0};
+    double seconds{0};
+    SearchStats stats; // per iteration, with -DSTATS only
+};
+
+
+/// @brief The solver as a library: the tables of a goal are built once 
+/// and shared read-only by the puzzles heading for it, which can be 
+/// solved from any number of threads at once. A search gives up past 
+/// its deadline or once its token is cancelled, within POLL_INTERVAL 
+/// nodes. The options are those of the command line.
+struct Solver {
+
+    Solver(const Target& t, const ArgParser& ap):
+        ap(ap),
+        goal(std::make_unique<Goal>(t, ap)),
+        pruning(std::make_unique<MovePruning>(ap.prune_length)) {
+    }
+
+    /// @param tiles of the puzzle in reading order, 0 for the blank
+    SolveResult solve(const std::vector<int>& tiles,
+                      std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(),
+                      const CancellationToken* token = nullptr) const {
+        const auto start = std::chrono::steady_clock::now();
+        const int dim = std::sqrt(goal->target.size());
+        
+        if(int(tiles.size()) != dim * dim) {
+            throw std::runtime_error("The puzzle does not have the size of the target!");
+        }
+
+        std::vector<bool> seen(tiles.size(), false);
+        for(int tile: tiles) {
+            if(tile < 0 || tile >= int(tiles.size()) || seen[tile]) {
+                throw std::runtime_error("The tiles are not a permutation of 0 to " +
+                                         std::to_string(tiles.size() - 1) + "!");
+            }
+            seen[tile] = true;
+        }
+
+        Solution s(goal->target);
+        goal->configure(s, ap);
+        s.threads = ap.threads;
+        s.pruning = pruning.get();
+        s.deadline = deadline;
+        s.token = token;
+
+        for(int id = 0; id < dim * dim; ++id) {
+            s.b.tiles[id / dim][id % dim] = tiles[id];
+        }
+        s.b.blank_coordinates();
+
+        SolveResult result;
+        if(not(s.b.solvable())) {
+            result.status = SolveResult::Status::UNSOLVABLE;
+            return result;
+        }
+
+        std::unique_ptr<TranspositionTable> tt;
+        if(ap.tt_megabytes) {
+            tt = std::make_unique<TranspositionTable>(ap.tt_megabytes);
+            s.tt = tt.get();
+        }
+
+        s.solve();
+
+        if(s.cancelled) {
+            result.status = SolveResult::Status::CANCELLED;
+        } else if(s.timed_out) {
+            result.status = SolveResult::Status::TIMED_OUT;
+        }
+        if(s.sol_cost != INT_MAX) {
+            result.cost = s.sol_cost;
+            for(int i = 0; i < s.path.size(); ++i) {
+                result.moves.push_back(Board::move_order[s.path[i]]);
+            }
+        }
+
+        result.nodes = s.nodes;
+        result.iterations = s.iterations;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.stats = std::move(s.stats);
+        return result;
+    }
+
+    const Target& target() const {
+        return goal->target;
+    }
+
+private:
+    ArgParser ap;
+    std::unique_ptr<Goal> goal; // through a pointer, as a Solution needs a mutable Target
+    std::unique_ptr<MovePruning> pruning;
+};
+
+
+/// @brief reads puzzles until the end of the stream, solves them on 
+/// `threads` threads, one puzzle per job, and prints the solutions in 
+/// input order. Puzzles heading for the same goal share its tables,
+/// each thread has a transposition table of its own, if any.
+void solve_batch(std::istream& is, std::ostream& os, const ArgParser& ap,
+                 const MovePruning& pruning) {
+    std::map<std::pair<int, int>, std::unique_ptr<Goal>> goals; // by (size, goal blank cell)
+    std::vector<std::unique_ptr<Solution>> solutions;
+    std::vector<std::string> errors; // of the puzzles without a solution
+
+    while(is >> std::ws && is.peek() != EOF) {
+        Target t;
+        is >> t;
+
+        std::unique_ptr<Goal>& goal = goals[{t.size(), t.goal(0)}];
+        if(not(goal)) {
+            goal = std::make_unique<Goal>(t, ap);
+        }
+
+        solutions.push_back(std::make_unique<Solution>(goal->target));
+        errors.emplace_back();
+        goal->configure(*solutions.back(), ap);
+        solutions.back()->pruning = &pruning;
+
+        try {
+            is >> *solutions.back();
+        } catch(const std::runtime_error& e) { // unsolvable, the board is consumed
+            solutions.back().reset();
+            errors.back() = e.what();
+        }
+    }
+
+    std::vector<std::unique_ptr<TranspositionTable>> tts(ap.threads);
+    for(auto& tt: tts) {
+        if(ap.tt_megabytes) {
+            tt = std::make_unique<TranspositionTable>(ap.tt_megabytes);
+        }
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    work_stealing_for(solutions.size(), ap.threads, [&solutions, &tts](int i, int w) {
+        if(solutions[i]) {
+            solutions[i]->tt = tts[w].get();
+            solutions[i]->solve();
+        }
+    });
+
+    auto stop = std::chrono::high_resolution_clock::now();
+
+    if(ap.time) {
+        auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(stop - start);
+        os << "\nExecution time: " << duration.count() << "s for " 
+           << solutions.size() << " puzzles\n\n" << std::endl;
+    }
+
+    for(std::size_t i = 0; i < solutions.size(); ++i) {
+        if(solutions[i]) {
+            os << *solutions[i];
+        } else {
+            os << errors[i] << "\n\n";
+        }
+    }
+
+    if(ap.stats) { // an array in input order, null for the puzzles without a solution
+        std::cerr << '[';
+        for(std::size_t i = 0; i < solutions.size(); ++i) {
+            std::cerr << (i ? ",\n " : "");
+            if(solutions[i]) {
+                solutions[i]->stats.write_json(std::cerr, solutions[i]->sol_cost);
+            } else {
+                std::cerr << "null";
+            }
+        }
+        std::cerr << ']' << std::endl;
+    }
+}
+
+
+
+#ifndef SOLVER_NO_MAIN // defined by the programs linking the solver, e.g. tests/benchmark.cpp
+
+int main(int argc, char** argv) try {
+
+    ArgParser ap(argv);
+
+    if(ap.stats && not(SearchStats::ENABLED)) {
+        throw std::runtime_error("Compile with -DSTATS for stats!");
+    }
+
+    if(ap.prune_length < 2) {
+        throw std::runtime_error("Pruning needs sequences of at least 2 moves!");
+    }
+    const MovePruning pruning(ap.prune_length);
+
+    if(ap.batch) {
+        solve_batch(std::cin, std::cout, ap, pruning);
+        return 0;
+    }
+
+    Target t;
+    std::cin >> t;
+
+    Goal goal(t, ap);
+
+    Solution s(goal.target);
+    goal.configure(s, ap);
+    s.threads = ap.threads;
+    s.pruning = &pruning;
+    std::cin >> s;
+
+    std::unique_ptr<TranspositionTable> tt;
+    if(ap.tt_megabytes) {
+        tt = std::make_unique<TranspositionTable>(ap.tt_megabytes);
+        s.tt = tt.get();
+    }
+
+    if(ap.time) {
+        auto start = std::chrono::high_resolution_clock::now();
+        s.solve();
+        auto stop = std::chrono::high_resolution_clock::now();
+    
+        auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(stop - start);
+        std::cout << "\nExecution time: " << duration.count() << "s\n\n" << std::endl;
+
+    } else {
+        s.solve();
+    }
+
+    std::cout << s;
+
+    if(ap.stats) {
+        s.stats.write_json(std::cerr, s.sol_cost);
+        std::cerr << std::endl;
+    }
+
+    return 0;
+
+} catch(const std::exception& e) { 
+
+    std::cout << e.what() << std::endl; 
+}
+
+#endif
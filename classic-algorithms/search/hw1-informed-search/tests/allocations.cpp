@@ -0,0 +1,179 @@
+// Counts the heap allocations of the IDA* inner loop, which makes none:
+// every iteration of every test case is searched with the allocator armed,
+// on each board type, with each heuristic.
+//
+//   g++ allocations.cpp -O2 -std=c++17 -pthread -o allocations
+//   ./allocations [cases directory]
+//
+// Exits with 1 if a search allocates or finds a cost other than the expected one.
+
+#include "common.hpp"
+
+#include <cstdlib>
+#include <new>
+
+
+static bool armed{false}; // the searches counted are single-threaded
+static std::uint64_t allocations{0};
+
+/// @param alignment 0 for the default one
+static void* allocate(std::size_t size, std::size_t alignment) {
+    if(armed) {
+        ++allocations;
+    }
+    size = size ? size : 1;
+    void* p = alignment ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                        : std::malloc(size);
+    if(p) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// every replaceable form, the nothrow ones call these
+void* operator new(std::size_t size) { return allocate(size, 0); }
+void* operator new[](std::size_t size) { return allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t al) { return allocate(size, std::size_t(al)); }
+void* operator new[](std::size_t size, std::align_val_t al) { return allocate(size, std::size_t(al)); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+
+/// @brief IDA* the way Solution::idastar runs it, with the allocator
+/// armed around the searches of the iterations only
+/// @return the allocations counted
+template<typename B, typename H>
+std::uint64_t count_search(Solution& s, const B& root, H heur) {
+    const int h = heur.init(root);
+    s.path.clear();
+    s.prune_state = 0;
+    allocations = 0;
+
+    for(int threshold = h; ; ) {
+        B b = root;
+        H eval = heur;
+        if(s.tt) {
+            s.tt->next_iteration();
+        }
+
+        armed = true;
+        const int temp = s.search(b, eval, 0, h, threshold);
+        armed = false;
+
+        if(temp == Solution::FOUND) {
+            return allocations;
+        }
+        threshold = temp;
+    }
+}
+
+template<typename B, typename H>
+std::uint64_t count_weighted(Solution& s, const B& root, const H& heur) {
+    if(s.weight != 100) {
+        return count_search(s, root, WeightedEvaluator<H>(heur, s.weight));
+    }
+    return count_search(s, root, heur);
+}
+
+template<typename B>
+std::uint64_t count(Solution& s, const B& root) {
+    switch(s.heuristic) {
+        case Heuristic::PDB:
+            return count_weighted(s, root, PdbEvaluator(*s.pdb, s.target));
+        case Heuristic::LINEAR_CONFLICT:
+            return count_weighted(s, root, LinearConflictEvaluator(s.target));
+        case Heuristic::WALKING_DISTANCE:
+            return count_weighted(s, root, WalkingDistanceEvaluator(*s.wd, s.target));
+        default:
+            return count_weighted(s, root, ManhattanEvaluator{s.target});
+    }
+}
+
+/// @brief the allocations of the searches on a packed, an array and a generic board
+template<int DIM>
+std::array<std::uint64_t, 3> count_boards(Solution& s) {
+    return {count(s, PackedBoard<DIM>(s.b)), count(s, ArrayBoard<DIM>(s.b)), count(s, s.b)};
+}
+
+
+int main(int argc, char** argv) try {
+
+    const std::string cases = argc > 1 ? argv[1] : "cases";
+    const std::vector<std::vector<std::string>> configs{
+        {"h=manhattan"}, {"h=lc", "prune=8"}, {"h=wd", "tt=16"}, {"h=pdb"}, {"h=lc", "w=2"},
+    };
+
+    int failed{0};
+
+    for(const std::vector<std::string>& config: configs) {
+        std::vector<char*> args{argv[0]};
+        for(const std::string& arg: config) {
+            args.push_back(const_cast<char*>(arg.c_str()));
+        }
+        args.push_back(nullptr);
+
+        const ArgParser ap(args.data());
+        const MovePruning pruning(ap.prune_length);
+        std::unique_ptr<TranspositionTable> tt;
+        if(ap.tt_megabytes) {
+            tt = std::make_unique<TranspositionTable>(ap.tt_megabytes);
+        }
+        std::map<std::pair<int, int>, std::unique_ptr<Goal>> goals; // by (size, goal blank cell)
+
+        for(const TestCase& c: load_cases(cases)) {
+            std::istringstream is(c.input);
+            Target t;
+            is >> t;
+            std::unique_ptr<Goal>& goal = goals[{t.size(), t.goal(0)}];
+            if(not(goal)) {
+                goal = std::make_unique<Goal>(t, ap);
+            }
+
+            Solution s(goal->target);
+            goal->configure(s, ap);
+            s.pruning = &pruning;
+            s.tt = tt.get();
+            try {
+                is >> s;
+            } catch(const std::runtime_error&) { // without a solution
+                continue;
+            }
+
+            std::array<std::uint64_t, 3> counts{};
+            switch(s.b.size()) {
+                case 3: counts = count_boards<3>(s); break;
+                case 4: counts = count_boards<4>(s); break;
+                default: throw std::runtime_error("Only 8 and 15-puzzles are counted!");
+            }
+
+            // the path is that of the last search
+            const bool ok = s.path.size() == s.sol_cost &&
+                            (s.weight == 100 ? s.sol_cost == c.expected
+                                             : s.sol_cost * 100 <= c.expected * s.weight) &&
+                            counts == std::array<std::uint64_t, 3>{};
+            failed += not(ok);
+
+            std::cout << c.name;
+            for(const std::string& arg: config) {
+                std::cout << ' ' << arg;
+            }
+            std::cout << ": cost " << s.sol_cost << ", allocations packed " << counts[0]
+                      << ", array " << counts[1] << ", generic " << counts[2]
+                      << (ok ? "" : " FAILED") << std::endl;
+        }
+    }
+
+    std::cout << (failed ? std::to_string(failed) + " failed" : "No allocations") << std::endl;
+    return failed ? 1 : 0;
+
+} catch(const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+}
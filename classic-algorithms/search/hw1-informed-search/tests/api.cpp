@@ -0,0 +1,149 @@
+// Exercises the library API: the test cases solved from many threads at
+// once, a hard 15-puzzle cut off by a deadline, cancelled from another
+// thread, and searched anytime past its deadline.
+//
+//   g++ api.cpp -O2 -std=c++17 -pthread -o api
+//   ./api [cases directory]
+//
+// Exits with 1 if any check fails.
+
+#include "common.hpp"
+
+#include <numeric>
+
+
+static int failed{0};
+
+void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "ok     " : "FAILED ") << what << std::endl;
+    failed += not(ok);
+}
+
+int main(int argc, char** argv) try {
+
+    const std::string cases = argc > 1 ? argv[1] : "cases";
+
+    // every case on every thread, the solvers shared by all of them
+    struct Case {
+        std::string name;
+        std::vector<int> tiles;
+        int expected;
+        const Solver* solver;
+    };
+    std::map<std::pair<int, int>, std::unique_ptr<Solver>> solvers; // by (size, goal blank cell)
+    std::vector<Case> all;
+
+    for(const TestCase& c: load_cases(cases)) {
+        std::unique_ptr<Solver>& solver = solvers[{c.target.size(), c.target.goal(0)}];
+        if(not(solver)) {
+            solver = make_solver(c.target, {"h=lc"});
+        }
+        all.push_back({c.name, c.tiles, c.expected, solver.get()});
+    }
+
+    const int threads = 8;
+    std::vector<int> wrong(threads, 0);
+    std::vector<std::thread> workers;
+    for(int w = 0; w < threads; ++w) {
+        workers.emplace_back([&all, &wrong, w]() {
+            for(int i = 0; i < int(all.size()); ++i) {
+                const Case& c = all[(i + w) % all.size()];
+                const SolveResult result = c.solver->solve(c.tiles);
+                const bool ok = c.expected < 0 ? result.status == SolveResult::Status::UNSOLVABLE
+                                               : result.status == SolveResult::Status::SOLVED &&
+                                                 result.cost == c.expected &&
+                                                 reaches_goal(c.tiles, result, c.solver->target());
+                wrong[w] += not(ok);
+            }
+        });
+    }
+    for(std::thread& worker: workers) {
+        worker.join();
+    }
+    check(std::accumulate(wrong.begin(), wrong.end(), 0) == 0,
+          std::to_string(all.size()) + " cases on " + std::to_string(threads) + " threads at once");
+
+    // Korf's 17th, 66 moves, takes seconds with the Manhattan distance
+    const std::vector<int> hard{15, 14, 0, 4, 11, 1, 6, 13, 7, 5, 8, 9, 3, 2, 10, 12};
+    const auto limit = std::chrono::milliseconds(50);
+    const double slack = 0.2; // seconds
+
+    {
+        const std::unique_ptr<Solver> solver = make_solver("15 0", {"h=manhattan"});
+        const SolveResult result = solver->solve(hard, std::chrono::steady_clock::now() + limit);
+        check(result.status == SolveResult::Status::TIMED_OUT && result.cost == -1 &&
+              result.seconds < slack && result.nodes > 0,
+              "deadline, stopped after " + std::to_string(result.seconds) + " s");
+    }
+
+    for(const std::string threads: {"threads=1", "threads=4"}) {
+        const std::unique_ptr<Solver> solver = make_solver("15 0", {"h=manhattan", threads});
+        CancellationToken token;
+        std::thread canceller([&token, limit]() {
+            std::this_thread::sleep_for(limit);
+            token.cancel();
+        });
+        const SolveResult result = solver->solve(hard, std::chrono::steady_clock::time_point::max(), &token);
+        canceller.join();
+        check(result.status == SolveResult::Status::CANCELLED && result.seconds < slack,
+              "cancellation with " + threads + ", stopped after " + std::to_string(result.seconds) + " s");
+    }
+
+    {
+        const std::unique_ptr<Solver> solver = make_solver("15 0", {"h=manhattan", "budget=10"});
+        const SolveResult result = solver->solve(hard, std::chrono::steady_clock::now() + limit);
+        check(result.status == SolveResult::Status::TIMED_OUT && result.cost >= 66 &&
+              reaches_goal(hard, result, solver->target()) && result.seconds < slack,
+              "anytime past the deadline, cost " + std::to_string(result.cost));
+    }
+
+    {
+        // anytime within the budget: the later runs, bounded by the best cost, end at the root
+        std::map<std::pair<int, int>, std::unique_ptr<Solver>> anytime;
+        int optimal{0};
+        for(const Case& c: all) {
+            const Target& t = c.solver->target();
+            std::unique_ptr<Solver>& solver = anytime[{t.size(), t.goal(0)}];
+            if(not(solver)) {
+                solver = make_solver(t, {"h=lc", "budget=10"});
+            }
+            const SolveResult result = solver->solve(c.tiles);
+            optimal += c.expected < 0 ? result.status == SolveResult::Status::UNSOLVABLE
+                                      : result.status == SolveResult::Status::SOLVED &&
+                                        result.cost == c.expected && reaches_goal(c.tiles, result, t);
+        }
+        check(optimal == int(all.size()),
+              "anytime, " + std::to_string(optimal) + " of " + std::to_string(all.size()) + " cases optimal");
+    }
+
+    {
+        // out of range, duplicated, no blank, negative: rejected, the shared target left as it was
+        const std::unique_ptr<Solver> solver = make_solver("8 -1", {"h=lc"});
+        const std::vector<std::vector<int>> invalid{
+            {1, 2, 3, 4, 5, 6, 7, 99, 0}, {1, 2, 3, 4, 5, 6, 7, 7, 0},
+            {1, 2, 3, 4, 5, 6, 7, 8, 9}, {1, 2, 3, 4, 5, 6, 7, -8, 0},
+        };
+        int rejected{0};
+        for(const std::vector<int>& tiles: invalid) {
+            try {
+                solver->solve(tiles);
+            } catch(const std::runtime_error&) {
+                ++rejected;
+            }
+        }
+
+        const std::vector<int> valid{1, 2, 3, 4, 5, 6, 0, 7, 8};
+        const SolveResult result = solver->solve(valid);
+        check(rejected == int(invalid.size()) && solver->target().size() == 9 &&
+              result.status == SolveResult::Status::SOLVED && result.cost == 2 &&
+              reaches_goal(valid, result, solver->target()),
+              "invalid tiles rejected, " + std::to_string(rejected) + " of " + std::to_string(invalid.size()));
+    }
+
+    std::cout << (failed ? std::to_string(failed) + " failed" : "All passed") << std::endl;
+    return failed ? 1 : 0;
+
+} catch(const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+}
@@ -0,0 +1,65 @@
+// Checks the A* and bidirectional engines on the test cases with every
+// heuristic: the cost is the optimal one and the moves reach the goal,
+// both with room for all the states and with too little, when IDA* takes
+// over. Prints the nodes and time of both and IDA* for every case.
+//
+//   g++ astar.cpp -O2 -std=c++17 -pthread -o astar
+//   ./astar [cases directory]
+//
+// Exits with 1 if any check fails.
+
+#include "common.hpp"
+
+
+int main(int argc, char** argv) try {
+
+    const std::string cases = argc > 1 ? argv[1] : "cases";
+    int failed{0};
+
+    for(const std::string h: {"h=manhattan", "h=lc", "h=wd", "h=pdb"}) {
+        std::map<std::pair<int, int>, std::array<std::unique_ptr<Solver>, 5>> solvers; // by (size, goal blank cell)
+
+        for(const TestCase& c: load_cases(cases)) {
+            const Target& t = c.target;
+            const std::vector<int>& tiles = c.tiles;
+            const int expected = c.expected;
+
+            // IDA*, A* and the bidirectional search with room for all the states and in 1 MB
+            std::array<std::unique_ptr<Solver>, 5>& s = solvers[{t.size(), t.goal(0)}];
+            if(not(s[0])) {
+                s[0] = make_solver(t, {h});
+                s[1] = make_solver(t, {h, "astar=1024"});
+                s[2] = make_solver(t, {h, "astar=1"});
+                s[3] = make_solver(t, {h, "bidir=1024"});
+                s[4] = make_solver(t, {h, "bidir=1"});
+            }
+
+            std::array<SolveResult, 5> results;
+            for(int i = 0; i < 5; ++i) {
+                results[i] = s[i]->solve(tiles);
+            }
+
+            bool ok{true};
+            for(const SolveResult& result: results) {
+                ok = ok && (expected < 0 ? result.status == SolveResult::Status::UNSOLVABLE
+                                         : result.status == SolveResult::Status::SOLVED &&
+                                           result.cost == expected && reaches_goal(tiles, result, t));
+            }
+            failed += not(ok);
+
+            std::cout << c.name << ' ' << h << ": cost " << results[1].cost
+                      << ", IDA* " << results[0].nodes << " nodes in " << results[0].seconds
+                      << " s, A* " << results[1].nodes << " nodes in " << results[1].seconds
+                      << " s, bidirectional " << results[3].nodes << " nodes in " << results[3].seconds
+                      << " s, 1 MB " << results[2].seconds << " s, " << results[4].seconds << " s"
+                      << (ok ? "" : " FAILED") << std::endl;
+        }
+    }
+
+    std::cout << (failed ? std::to_string(failed) + " failed" : "All passed") << std::endl;
+    return failed ? 1 : 0;
+
+} catch(const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+}
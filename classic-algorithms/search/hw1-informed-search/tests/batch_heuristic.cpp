@@ -0,0 +1,93 @@
+// Checks the kernels of BatchEvaluator against LinearConflictEvaluator on
+// random 8 and 15-puzzle boards, for goals with the blank in different
+// cells, and times every kernel the CPU supports.
+//
+//   g++ batch_heuristic.cpp -O2 -std=c++17 -pthread -o batch_heuristic
+//   ./batch_heuristic [boards]
+//
+// Exits with 1 if a kernel differs from the evaluator on any board.
+
+#define SOLVER_NO_MAIN
+#include "../solution.cpp"
+
+#include <numeric>
+#include <random>
+#include <sstream>
+
+
+/// @return the boards that differ
+template<int DIM>
+int check(int zero_id, int count, std::mt19937_64& rng) {
+    using Kernel = typename BatchEvaluator<DIM>::Kernel;
+    constexpr int CELLS = DIM * DIM;
+
+    Target t;
+    std::istringstream("" + std::to_string(CELLS - 1) + ' ' + std::to_string(zero_id)) >> t;
+
+    // any placement of the tiles, solvable or not, is a board to evaluate
+    std::vector<PackedBoard<DIM>> boards;
+    std::vector<int> expected;
+    std::array<int, CELLS> tiles;
+    std::iota(tiles.begin(), tiles.end(), 0);
+    LinearConflictEvaluator reference(t);
+
+    dict positions = t.posistions;
+    Board b(DIM, positions);
+    for(int i = 0; i < count; ++i) {
+        std::shuffle(tiles.begin(), tiles.end(), rng);
+        for(int id = 0; id < CELLS; ++id) {
+            b.tiles[id / DIM][id % DIM] = tiles[id];
+        }
+        b.blank_coordinates();
+        boards.emplace_back(b);
+        expected.push_back(reference.init(boards.back()));
+    }
+
+    int failed{0};
+
+    for(const Kernel kernel: {Kernel::SCALAR, Kernel::SSSE3, Kernel::AVX2}) {
+        if(not(BatchEvaluator<DIM>::supported(kernel))) {
+            continue;
+        }
+
+        const BatchEvaluator<DIM> batch(t, kernel);
+        std::vector<int> h(count);
+
+        const auto start = std::chrono::steady_clock::now();
+        batch.evaluate(boards.data(), count, h.data());
+        const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+        const int differ = count - std::inner_product(h.begin(), h.end(), expected.begin(), 0,
+                                                      std::plus<>(), std::equal_to<>());
+        failed += differ;
+
+        std::cout << CELLS - 1 << "-puzzle, blank goal " << zero_id << ", "
+                  << BatchEvaluator<DIM>::name(kernel) << ": "
+                  << count / seconds.count() << " boards/s"
+                  << (differ ? ", " + std::to_string(differ) + " differ" : "") << std::endl;
+    }
+
+    return failed;
+}
+
+
+int main(int argc, char** argv) try {
+
+    const int count = argc > 1 ? std::stoi(argv[1]) : 1000001; // odd, for the tail of the AVX2 kernel
+    std::mt19937_64 rng(1);
+
+    int failed{0};
+    for(const int zero_id: {0, 4, 8}) {
+        failed += check<3>(zero_id, count, rng);
+    }
+    for(const int zero_id: {0, 6, 15}) {
+        failed += check<4>(zero_id, count, rng);
+    }
+
+    std::cout << (failed ? std::to_string(failed) + " differ" : "All kernels agree") << std::endl;
+    return failed ? 1 : 0;
+
+} catch(const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+}
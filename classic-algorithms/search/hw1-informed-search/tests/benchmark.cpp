@@ -0,0 +1,405 @@
+// In-process benchmark of the solver: instance sets solved many times over,
+// one JSON object per line for every instance and a summary per set.
+//
+//   g++ benchmark.cpp -O2 -std=c++17 -pthread -o benchmark
+//   ./benchmark sets=cases,walks,korf reps=5 h=pdb
+//
+// Any argument that is not the benchmark's own is passed on to the solver.
+// The nodes are those every search counts; built with -DSTATS it also
+// reports the nodes expanded and generated, but then times the counters too.
+
+#include "common.hpp"
+
+#include <random>
+
+
+/// @brief Korf's 100 random 15-puzzles with their optimal costs,
+/// the goal has the blank in the top left corner
+static const std::pair<std::array<int, 16>, int> KORF_100[] = {
+    {{14, 13, 15, 7, 11, 12, 9, 5, 6, 0, 2, 1, 4, 8, 10, 3}, 57},
+    {{13, 5, 4, 10, 9, 12, 8, 14, 2, 3, 7, 1, 0, 15, 11, 6}, 55},
+    {{14, 7, 8, 2, 13, 11, 10, 4, 9, 12, 5, 0, 3, 6, 1, 15}, 59},
+    {{5, 12, 10, 7, 15, 11, 14, 0, 8, 2, 1, 13, 3, 4, 9, 6}, 56},
+    {{4, 7, 14, 13, 10, 3, 9, 12, 11, 5, 6, 15, 1, 2, 8, 0}, 56},
+    {{14, 7, 1, 9, 12, 3, 6, 15, 8, 11, 2, 5, 10, 0, 4, 13}, 52},
+    {{2, 11, 15, 5, 13, 4, 6, 7, 12, 8, 10, 1, 9, 3, 14, 0}, 52},
+    {{12, 11, 15, 3, 8, 0, 4, 2, 6, 13, 9, 5, 14, 1, 10, 7}, 50},
+    {{3, 14, 9, 11, 5, 4, 8, 2, 13, 12, 6, 7, 10, 1, 15, 0}, 46},
+    {{13, 11, 8, 9, 0, 15, 7, 10, 4, 3, 6, 14, 5, 12, 2, 1}, 59},
+    {{5, 9, 13, 14, 6, 3, 7, 12, 10, 8, 4, 0, 15, 2, 11, 1}, 57},
+    {{14, 1, 9, 6, 4, 8, 12, 5, 7, 2, 3, 0, 10, 11, 13, 15}, 45},
+    {{3, 6, 5, 2, 10, 0, 15, 14, 1, 4, 13, 12, 9, 8, 11, 7}, 46},
+    {{7, 6, 8, 1, 11, 5, 14, 10, 3, 4, 9, 13, 15, 2, 0, 12}, 59},
+    {{13, 11, 4, 12, 1, 8, 9, 15, 6, 5, 14, 2, 7, 3, 10, 0}, 62},
+    {{1, 3, 2, 5, 10, 9, 15, 6, 8, 14, 13, 11, 12, 4, 7, 0}, 42},
+    {{15, 14, 0, 4, 11, 1, 6, 13, 7, 5, 8, 9, 3, 2, 10, 12}, 66},
+    {{6, 0, 14, 12, 1, 15, 9, 10, 11, 4, 7, 2, 8, 3, 5, 13}, 55},
+    {{7, 11, 8, 3, 14, 0, 6, 15, 1, 4, 13, 9, 5, 12, 2, 10}, 46},
+    {{6, 12, 11, 3, 13, 7, 9, 15, 2, 14, 8, 10, 4, 1, 5, 0}, 52},
+    {{12, 8, 14, 6, 11, 4, 7, 0, 5, 1, 10, 15, 3, 13, 9, 2}, 54},
+    {{14, 3, 9, 1, 15, 8, 4, 5, 11, 7, 10, 13, 0, 2, 12, 6}, 59},
+    {{10, 9, 3, 11, 0, 13, 2, 14, 5, 6, 4, 7, 8, 15, 1, 12}, 49},
+    {{7, 3, 14, 13, 4, 1, 10, 8, 5, 12, 9, 11, 2, 15, 6, 0}, 54},
+    {{11, 4, 2, 7, 1, 0, 10, 15, 6, 9, 14, 8, 3, 13, 5, 12}, 52},
+    {{5, 7, 3, 12, 15, 13, 14, 8, 0, 10, 9, 6, 1, 4, 2, 11}, 58},
+    {{14, 1, 8, 15, 2, 6, 0, 3, 9, 12, 10, 13, 4, 7, 5, 11}, 53},
+    {{13, 14, 6, 12, 4, 5, 1, 0, 9, 3, 10, 2, 15, 11, 8, 7}, 52},
+    {{9, 8, 0, 2, 15, 1, 4, 14, 3, 10, 7, 5, 11, 13, 6, 12}, 54},
+    {{12, 15, 2, 6, 1, 14, 4, 8, 5, 3, 7, 0, 10, 13, 9, 11}, 47},
+    {{12, 8, 15, 13, 1, 0, 5, 4, 6, 3, 2, 11, 9, 7, 14, 10}, 50},
+    {{14, 10, 9, 4, 13, 6, 5, 8, 2, 12, 7, 0, 1, 3, 11, 15}, 59},
+    {{14, 3, 5, 15, 11, 6, 13, 9, 0, 10, 2, 12, 4, 1, 7, 8}, 60},
+    {{6, 11, 7, 8, 13, 2, 5, 4, 1, 10, 3, 9, 14, 0, 12, 15}, 52},
+    {{1, 6, 12, 14, 3, 2, 15, 8, 4, 5, 13, 9, 0, 7, 11, 10}, 55},
+    {{12, 6, 0, 4, 7, 3, 15, 1, 13, 9, 8, 11, 2, 14, 5, 10}, 52},
+    {{8, 1, 7, 12, 11, 0, 10, 5, 9, 15, 6, 13, 14, 2, 3, 4}, 58},
+    {{7, 15, 8, 2, 13, 6, 3, 12, 11, 0, 4, 10, 9, 5, 1, 14}, 53},
+    {{9, 0, 4, 10, 1, 14, 15, 3, 12, 6, 5, 7, 11, 13, 8, 2}, 49},
+    {{11, 5, 1, 14, 4, 12, 10, 0, 2, 7, 13, 3, 9, 15, 6, 8}, 54},
+    {{8, 13, 10, 9, 11, 3, 15, 6, 0, 1, 2, 14, 12, 5, 4, 7}, 54},
+    {{4, 5, 7, 2, 9, 14, 12, 13, 0, 3, 6, 11, 8, 1, 15, 10}, 42},
+    {{11, 15, 14, 13, 1, 9, 10, 4, 3, 6, 2, 12, 7, 5, 8, 0}, 64},
+    {{12, 9, 0, 6, 8, 3, 5, 14, 2, 4, 11, 7, 10, 1, 15, 13}, 50},
+    {{3, 14, 9, 7, 12, 15, 0, 4, 1, 8, 5, 6, 11, 10, 2, 13}, 51},
+    {{8, 4, 6, 1, 14, 12, 2, 15, 13, 10, 9, 5, 3, 7, 0, 11}, 49},
+    {{6, 10, 1, 14, 15, 8, 3, 5, 13, 0, 2, 7, 4, 9, 11, 12}, 47},
+    {{8, 11, 4, 6, 7, 3, 10, 9, 2, 12, 15, 13, 0, 1, 5, 14}, 49},
+    {{10, 0, 2, 4, 5, 1, 6, 12, 11, 13, 9, 7, 15, 3, 14, 8}, 59},
+    {{12, 5, 13, 11, 2, 10, 0, 9, 7, 8, 4, 3, 14, 6, 15, 1}, 53},
+    {{10, 2, 8, 4, 15, 0, 1, 14, 11, 13, 3, 6, 9, 7, 5, 12}, 56},
+    {{10, 8, 0, 12, 3, 7, 6, 2, 1, 14, 4, 11, 15, 13, 9, 5}, 56},
+    {{14, 9, 12, 13, 15, 4, 8, 10, 0, 2, 1, 7, 3, 11, 5, 6}, 64},
+    {{12, 11, 0, 8, 10, 2, 13, 15, 5, 4, 7, 3, 6, 9, 14, 1}, 56},
+    {{13, 8, 14, 3, 9, 1, 0, 7, 15, 5, 4, 10, 12, 2, 6, 11}, 41},
+    {{3, 15, 2, 5, 11, 6, 4, 7, 12, 9, 1, 0, 13, 14, 10, 8}, 55},
+    {{5, 11, 6, 9, 4, 13, 12, 0, 8, 2, 15, 10, 1, 7, 3, 14}, 50},
+    {{5, 0, 15, 8, 4, 6, 1, 14, 10, 11, 3, 9, 7, 12, 2, 13}, 51},
+    {{15, 14, 6, 7, 10, 1, 0, 11, 12, 8, 4, 9, 2, 5, 13, 3}, 57},
+    {{11, 14, 13, 1, 2, 3, 12, 4, 15, 7, 9, 5, 10, 6, 8, 0}, 66},
+    {{6, 13, 3, 2, 11, 9, 5, 10, 1, 7, 12, 14, 8, 4, 0, 15}, 45},
+    {{4, 6, 12, 0, 14, 2, 9, 13, 11, 8, 3, 15, 7, 10, 1, 5}, 57},
+    {{8, 10, 9, 11, 14, 1, 7, 15, 13, 4, 0, 12, 6, 2, 5, 3}, 56},
+    {{5, 2, 14, 0, 7, 8, 6, 3, 11, 12, 13, 15, 4, 10, 9, 1}, 51},
+    {{7, 8, 3, 2, 10, 12, 4, 6, 11, 13, 5, 15, 0, 1, 9, 14}, 47},
+    {{11, 6, 14, 12, 3, 5, 1, 15, 8, 0, 10, 13, 9, 7, 4, 2}, 61},
+    {{7, 1, 2, 4, 8, 3, 6, 11, 10, 15, 0, 5, 14, 12, 13, 9}, 50},
+    {{7, 3, 1, 13, 12, 10, 5, 2, 8, 0, 6, 11, 14, 15, 4, 9}, 51},
+    {{6, 0, 5, 15, 1, 14, 4, 9, 2, 13, 8, 10, 11, 12, 7, 3}, 53},
+    {{15, 1, 3, 12, 4, 0, 6, 5, 2, 8, 14, 9, 13, 10, 7, 11}, 52},
+    {{5, 7, 0, 11, 12, 1, 9, 10, 15, 6, 2, 3, 8, 4, 13, 14}, 44},
+    {{12, 15, 11, 10, 4, 5, 14, 0, 13, 7, 1, 2, 9, 8, 3, 6}, 56},
+    {{6, 14, 10, 5, 15, 8, 7, 1, 3, 4, 2, 0, 12, 9, 11, 13}, 49},
+    {{14, 13, 4, 11, 15, 8, 6, 9, 0, 7, 3, 1, 2, 10, 12, 5}, 56},
+    {{14, 4, 0, 10, 6, 5, 1, 3, 9, 2, 13, 15, 12, 7, 8, 11}, 48},
+    {{15, 10, 8, 3, 0, 6, 9, 5, 1, 14, 13, 11, 7, 2, 12, 4}, 57},
+    {{0, 13, 2, 4, 12, 14, 6, 9, 15, 1, 10, 3, 11, 5, 8, 7}, 54},
+    {{3, 14, 13, 6, 4, 15, 8, 9, 5, 12, 10, 0, 2, 7, 1, 11}, 53},
+    {{0, 1, 9, 7, 11, 13, 5, 3, 14, 12, 4, 2, 8, 6, 10, 15}, 42},
+    {{11, 0, 15, 8, 13, 12, 3, 5, 10, 1, 4, 6, 14, 9, 7, 2}, 57},
+    {{13, 0, 9, 12, 11, 6, 3, 5, 15, 8, 1, 10, 4, 14, 2, 7}, 53},
+    {{14, 10, 2, 1, 13, 9, 8, 11, 7, 3, 6, 12, 15, 5, 4, 0}, 62},
+    {{12, 3, 9, 1, 4, 5, 10, 2, 6, 11, 15, 0, 14, 7, 13, 8}, 49},
+    {{15, 8, 10, 7, 0, 12, 14, 1, 5, 9, 6, 3, 13, 11, 4, 2}, 55},
+    {{4, 7, 13, 10, 1, 2, 9, 6, 12, 8, 14, 5, 3, 0, 11, 15}, 44},
+    {{6, 0, 5, 10, 11, 12, 9, 2, 1, 7, 4, 3, 14, 8, 13, 15}, 45},
+    {{9, 5, 11, 10, 13, 0, 2, 1, 8, 6, 14, 12, 4, 7, 3, 15}, 52},
+    {{15, 2, 12, 11, 14, 13, 9, 5, 1, 3, 8, 7, 0, 10, 6, 4}, 65},
+    {{11, 1, 7, 4, 10, 13, 3, 8, 9, 14, 0, 15, 6, 5, 2, 12}, 54},
+    {{5, 4, 7, 1, 11, 12, 14, 15, 10, 13, 8, 6, 2, 0, 9, 3}, 50},
+    {{9, 7, 5, 2, 14, 15, 12, 10, 11, 3, 6, 1, 8, 13, 0, 4}, 57},
+    {{3, 2, 7, 9, 0, 15, 12, 4, 6, 11, 5, 14, 8, 13, 10, 1}, 57},
+    {{13, 9, 14, 6, 12, 8, 1, 2, 3, 4, 0, 7, 5, 10, 11, 15}, 46},
+    {{5, 7, 11, 8, 0, 14, 9, 13, 10, 12, 3, 15, 6, 1, 4, 2}, 53},
+    {{4, 3, 6, 13, 7, 15, 9, 0, 10, 5, 8, 11, 2, 12, 1, 14}, 50},
+    {{1, 7, 15, 14, 2, 6, 4, 9, 12, 11, 13, 3, 0, 8, 5, 10}, 49},
+    {{9, 14, 5, 7, 8, 15, 1, 2, 10, 4, 13, 6, 12, 0, 11, 3}, 44},
+    {{0, 11, 3, 12, 5, 2, 1, 9, 8, 10, 14, 15, 7, 4, 13, 6}, 54},
+    {{7, 15, 4, 0, 10, 9, 2, 5, 12, 11, 13, 6, 1, 3, 14, 8}, 57},
+    {{11, 4, 0, 8, 6, 10, 5, 13, 12, 7, 14, 3, 1, 2, 9, 15}, 54}
+};
+
+
+struct Instance {
+    std::string set;
+    std::string name;
+    std::string input; // in the solver's input format
+    int expected{-1}; // optimal cost if known
+};
+
+
+struct BenchArgs {
+
+    BenchArgs(char** args) {
+        solver_args.push_back(*args);
+
+        while(*(++args)) {
+            const std::string arg(*args);
+
+            if(arg.rfind("sets=", 0) == 0) {
+                sets = split(arg.substr(5));
+            } else if(arg.rfind("reps=", 0) == 0) {
+                reps = std::stoi(arg.substr(5));
+            } else if(arg.rfind("depths=", 0) == 0) {
+                depths.clear();
+                for(const std::string& d: split(arg.substr(7))) {
+                    depths.push_back(std::stoi(d));
+                }
+            } else if(arg.rfind("walks=", 0) == 0) {
+                walks = std::stoi(arg.substr(6));
+            } else if(arg.rfind("walk_n=", 0) == 0) {
+                walk_n = std::stoi(arg.substr(7));
+            } else if(arg.rfind("seed=", 0) == 0) {
+                seed = std::stoull(arg.substr(5));
+            } else if(arg.rfind("korf=", 0) == 0) {
+                korf = std::stoi(arg.substr(5));
+            } else if(arg.rfind("cases=", 0) == 0) {
+                cases = arg.substr(6);
+            } else {
+                solver_args.push_back(*args);
+            }
+        }
+        solver_args.push_back(nullptr);
+
+        if(reps < 1) {
+            throw std::runtime_error("Needs at least 1 repetition!");
+        }
+    }
+
+    static std::vector<std::string> split(const std::string& list) {
+        std::vector<std::string> items;
+        std::stringstream ss(list);
+        std::string item;
+        while(std::getline(ss, item, ',')) {
+            items.push_back(item);
+        }
+        return items;
+    }
+
+    std::vector<std::string> sets{"cases", "walks"};
+    int reps{5};
+    std::vector<int> depths{20, 30, 40}; // of the random walks
+    int walks{10}; // per depth
+    int walk_n{15}; // board of the random walks
+    std::uint64_t seed{1};
+    int korf{100}; // the first instances of Korf's 100
+    std::string cases{"cases"};
+    std::vector<char*> solver_args; // like argv
+};
+
+
+std::vector<Instance> case_instances(const std::string& dir) {
+    std::vector<Instance> instances;
+    for(const TestCase& c: load_cases(dir)) {
+        instances.push_back({"cases", c.name, c.input, c.expected});
+    }
+    return instances;
+}
+
+
+/// @brief boards `depth` random moves away from the goal with the blank
+/// last, never undoing the previous move
+std::vector<Instance> walk_instances(const BenchArgs& args) {
+    std::vector<Instance> instances;
+    const int dim = std::sqrt(args.walk_n + 1);
+
+    for(const int depth: args.depths) {
+        for(int i = 0; i < args.walks; ++i) {
+            std::mt19937_64 rng(args.seed * 1000003 + depth * 1000 + i);
+            std::vector<int> tiles(dim * dim);
+            for(int id = 0; id + 1 < dim * dim; ++id) {
+                tiles[id] = id + 1;
+            }
+
+            int blank = dim * dim - 1;
+            int last = -1;
+            for(int step = 0; step < depth; ) {
+                const int m = rng() % 4;
+                const int x = blank / dim + Board::steps[m].x;
+                const int y = blank % dim + Board::steps[m].y;
+                if(m == (last ^ 1) || x < 0 || x >= dim || y < 0 || y >= dim) {
+                    continue;
+                }
+
+                std::swap(tiles[blank], tiles[x * dim + y]);
+                blank = x * dim + y;
+                last = m;
+                ++step;
+            }
+
+            std::ostringstream input;
+            input << args.walk_n << "\n-1\n";
+            for(int id = 0; id < dim * dim; ++id) {
+                input << tiles[id] << (id % dim == dim - 1 ? '\n' : ' ');
+            }
+
+            instances.push_back({"walks", "walk-" + std::to_string(depth) + "-" + std::to_string(i),
+                                 input.str(), -1});
+        }
+    }
+    return instances;
+}
+
+
+std::vector<Instance> korf_instances(int count) {
+    std::vector<Instance> instances;
+
+    for(int i = 0; i < count && i < 100; ++i) {
+        std::ostringstream input;
+        input << "15\n0\n";
+        for(int id = 0; id < 16; ++id) {
+            input << KORF_100[i].first[id] << (id % 4 == 3 ? '\n' : ' ');
+        }
+        instances.push_back({"korf", "korf-" + std::to_string(i + 1), input.str(), KORF_100[i].second});
+    }
+    return instances;
+}
+
+
+/// @brief nearest-rank percentile of sorted values
+double percentile(const std::vector<double>& sorted, double p) {
+    const std::size_t rank = std::ceil(p / 100 * sorted.size());
+    return sorted[std::max<std::size_t>(rank, 1) - 1];
+}
+
+
+void write_seconds(std::ostream& os, std::vector<double> seconds) {
+    std::sort(seconds.begin(), seconds.end());
+    double sum{0};
+    for(const double s: seconds) {
+        sum += s;
+    }
+
+    os << "{\"min\": " << seconds.front()
+       << ", \"p50\": " << percentile(seconds, 50)
+       << ", \"p90\": " << percentile(seconds, 90)
+       << ", \"p99\": " << percentile(seconds, 99)
+       << ", \"max\": " << seconds.back()
+       << ", \"mean\": " << sum / seconds.size() << "}";
+}
+
+
+struct SetSummary {
+    int instances{0};
+    int failed{0}; // cost other than the expected one
+    std::uint64_t nodes{0};
+    std::vector<double> medians; // of the instances
+};
+
+
+int main(int, char** argv) try {
+
+    BenchArgs args(argv);
+    ArgParser ap(args.solver_args.data());
+    const MovePruning pruning(ap.prune_length);
+
+    std::unique_ptr<TranspositionTable> tt;
+    if(ap.tt_megabytes) {
+        tt = std::make_unique<TranspositionTable>(ap.tt_megabytes);
+    }
+
+    std::map<std::pair<int, int>, std::unique_ptr<Goal>> goals; // by (size, goal blank cell)
+    int failed{0};
+
+    for(const std::string& set: args.sets) {
+        std::vector<Instance> instances;
+        if(set == "cases") {
+            instances = case_instances(args.cases);
+        } else if(set == "walks") {
+            instances = walk_instances(args);
+        } else if(set == "korf") {
+            instances = korf_instances(args.korf);
+        } else {
+            throw std::runtime_error("Unknown set " + set + ", expected cases, walks or korf");
+        }
+
+        SetSummary summary;
+
+        for(const Instance& in: instances) {
+            std::vector<double> seconds;
+            std::uint64_t nodes{0};
+            SearchStats::Counters counters; // with -DSTATS only
+            int cost{-1};
+
+            try {
+                for(int rep = 0; rep < args.reps; ++rep) {
+                    std::istringstream is(in.input);
+                    Target t;
+                    is >> t;
+
+                    std::unique_ptr<Goal>& goal = goals[{t.size(), t.goal(0)}];
+                    if(not(goal)) { // built outside of the timing
+                        goal = std::make_unique<Goal>(t, ap);
+                    }
+
+                    Solution s(goal->target);
+                    goal->configure(s, ap);
+                    s.threads = ap.threads;
+                    s.pruning = &pruning;
+                    s.tt = tt.get();
+                    is >> s;
+
+                    auto start = std::chrono::steady_clock::now();
+                    s.solve();
+                    auto stop = std::chrono::steady_clock::now();
+
+                    seconds.push_back(std::chrono::duration<double>(stop - start).count());
+                    cost = s.sol_cost;
+                    nodes = s.nodes;
+                    counters = {};
+                    for(const SearchStats::Iteration& it: s.stats.iterations) {
+                        counters += it.counters;
+                    }
+                }
+            } catch(const std::runtime_error& e) { // without a solution
+                std::cout << "{\"set\": \"" << in.set << "\", \"name\": \"" << in.name
+                          << "\", \"error\": \"" << e.what() << "\"}" << std::endl;
+                continue;
+            }
+
+            const bool ok = in.expected < 0 || cost == in.expected;
+            std::vector<double> sorted(seconds);
+            std::sort(sorted.begin(), sorted.end());
+            const double median = percentile(sorted, 50);
+
+            summary.instances += 1;
+            summary.failed += not(ok);
+            summary.nodes += nodes;
+            summary.medians.push_back(median);
+
+            std::cout << "{\"set\": \"" << in.set << "\", \"name\": \"" << in.name
+                      << "\", \"cost\": " << cost << ", \"ok\": " << (ok ? "true" : "false")
+                      << ", \"nodes\": " << nodes << ", \"reps\": " << args.reps
+                      << ", \"nodes_per_second\": " << (median > 0 ? nodes / median : 0);
+            if constexpr(SearchStats::ENABLED) {
+                std::cout << ", \"expanded\": " << counters.expanded
+                          << ", \"generated\": " << counters.generated;
+            }
+            std::cout << ", \"seconds\": ";
+            write_seconds(std::cout, seconds);
+            std::cout << "}" << std::endl;
+        }
+
+        if(summary.instances) {
+            double total{0};
+            for(const double m: summary.medians) {
+                total += m;
+            }
+
+            std::cout << "{\"set\": \"" << set << "\", \"summary\": true, \"instances\": "
+                      << summary.instances << ", \"failed\": " << summary.failed
+                      << ", \"nodes\": " << summary.nodes << ", \"seconds_total\": " << total
+                      << ", \"nodes_per_second\": " << (total > 0 ? summary.nodes / total : 0)
+                      << ", \"seconds\": ";
+            write_seconds(std::cout, summary.medians); // of the instance medians
+            std::cout << "}" << std::endl;
+        }
+        failed += summary.failed;
+    }
+
+    return failed ? 1 : 0; // a wrong cost fails the gate
+
+} catch(const std::exception& e) {
+
+    std::cerr << e.what() << std::endl;
+    return 2;
+}
@@ -0,0 +1,94 @@
+// Shared by the tests: the solver linked in-process, the test cases read
+// from their directory, solvers made from command line options and a check
+// that the moves of a result solve the puzzle.
+
+#pragma once
+
+#define SOLVER_NO_MAIN
+#include "../solution.cpp"
+
+#include <filesystem>
+#include <sstream>
+
+
+struct TestCase {
+    std::string name; // of the input file, without the extension
+    std::string input; // in the solver's input format
+    int expected{-1}; // the optimal cost, -1 without a solution
+    Target target;
+    std::vector<int> tiles; // in reading order, 0 for the blank
+};
+
+/// @brief the cases of the directory, every `.in` with the cost in its `.out`, by name
+std::vector<TestCase> load_cases(const std::string& dir) {
+    std::vector<TestCase> cases;
+
+    for(const auto& entry: std::filesystem::directory_iterator(dir)) {
+        if(entry.path().extension() != ".in") {
+            continue;
+        }
+
+        TestCase c;
+        c.name = entry.path().stem().string();
+        std::ifstream in(entry.path());
+        c.input.assign(std::istreambuf_iterator<char>(in), {});
+
+        std::ifstream out(std::filesystem::path(entry.path()).replace_extension(".out"));
+        out >> c.expected;
+
+        std::istringstream is(c.input);
+        is >> c.target;
+        c.tiles.resize(c.target.size());
+        for(int& tile: c.tiles) {
+            is >> tile;
+        }
+        cases.push_back(c);
+    }
+
+    std::sort(cases.begin(), cases.end(), [](const TestCase& a, const TestCase& b) {
+        return a.name < b.name;
+    });
+    return cases;
+}
+
+std::unique_ptr<Solver> make_solver(const Target& t, const std::vector<std::string>& options) {
+    std::vector<char*> args{const_cast<char*>("test")};
+    for(const std::string& option: options) {
+        args.push_back(const_cast<char*>(option.c_str()));
+    }
+    args.push_back(nullptr);
+    return std::make_unique<Solver>(t, ArgParser(args.data()));
+}
+
+/// @param target the first line of the input, e.g. "15 0"
+std::unique_ptr<Solver> make_solver(const std::string& target, const std::vector<std::string>& options) {
+    std::istringstream is(target);
+    Target t;
+    is >> t;
+    return make_solver(t, options);
+}
+
+/// @brief whether the moves take the tiles to the goal in `cost` moves
+bool reaches_goal(std::vector<int> tiles, const SolveResult& result, const Target& t) {
+    const int dim = std::sqrt(tiles.size());
+    int zero = std::find(tiles.begin(), tiles.end(), 0) - tiles.begin();
+
+    for(const std::string& move: result.moves) {
+        const int m = std::find(Board::move_order.begin(), Board::move_order.end(), move) -
+                      Board::move_order.begin();
+        const int x = zero / dim + Board::steps[m].x;
+        const int y = zero % dim + Board::steps[m].y;
+        if(x < 0 || x >= dim || y < 0 || y >= dim) {
+            return false;
+        }
+        std::swap(tiles[zero], tiles[x * dim + y]);
+        zero = x * dim + y;
+    }
+
+    for(int id = 0; id < int(tiles.size()); ++id) {
+        if(t.goal(tiles[id]) != id) {
+            return false;
+        }
+    }
+    return result.cost == int(result.moves.size());
+}
@@ -0,0 +1,60 @@
+// Checks that pattern databases built on disk, with the frontier in sorted
+// run files, are the same as those built in memory, for several goals and
+// partitions. A small memory share forces many runs per layer.
+//
+//   g++ pdb_external.cpp -O2 -std=c++17 -pthread -o pdb_external
+//   ./pdb_external [threads]
+//
+// Exits with 1 if any table differs.
+
+#define SOLVER_NO_MAIN
+#include "../solution.cpp"
+
+#include <sstream>
+
+
+int main(int argc, char** argv) try {
+
+    const int threads = argc > 1 ? std::stoi(argv[1]) : 4;
+    const ExternalPdbBuild external{std::filesystem::temp_directory_path().string(), 1 << 20, threads};
+
+    // puzzle size and goal blank cell, partition
+    const std::vector<std::pair<std::string, std::string>> builds{
+        {"8 -1", "4-4"}, {"8 4", "3-5"}, {"8 0", "8"}, {"15 -1", "5-5-5"}, {"15 0", "3-4-4-4"},
+    };
+
+    int failed{0};
+
+    for(const auto& [goal, partition]: builds) {
+        Target t;
+        std::istringstream(goal) >> t;
+
+        auto start = std::chrono::steady_clock::now();
+        const AdditivePdb in_memory(t, partition);
+        const std::chrono::duration<double> memory_seconds = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        const AdditivePdb on_disk(t, partition, &external);
+        const std::chrono::duration<double> disk_seconds = std::chrono::steady_clock::now() - start;
+
+        bool same{true};
+        for(std::size_t i = 0; i < in_memory.patterns.size(); ++i) {
+            const PatternDatabase& a = in_memory.patterns[i];
+            const PatternDatabase& b = on_disk.patterns[i];
+            same = same && a.tiles == b.tiles &&
+                   std::equal(a.nibbles(), a.nibbles() + a.bytes(), b.nibbles());
+        }
+        failed += not(same);
+
+        std::cout << goal << " " << partition << ": " << (same ? "same" : "DIFFERENT")
+                  << ", " << memory_seconds.count() << " s in memory, "
+                  << disk_seconds.count() << " s on disk" << std::endl;
+    }
+
+    std::cout << (failed ? std::to_string(failed) + " differ" : "All the same") << std::endl;
+    return failed ? 1 : 0;
+
+} catch(const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+}
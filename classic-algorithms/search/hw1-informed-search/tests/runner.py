@@ -1,6 +1,7 @@
 import os
 import subprocess
 import time
+import sys
 
 # Specify the test-case directory
 test_case_directory = "./cases"
@@ -22,7 +23,7 @@ for in_file in in_files:
     # Run the program with the "in" file as input
     try:
         # Replace the following line with the command you want to run
-        cmd = ["../a.out"]
+        cmd = ["../a.out"] + sys.argv[1:] # optional solver arguments
 
         start_time = time.time()
 